@@ -121,6 +121,55 @@
  * 🏷️ For maximum async queue limit setting for an async client
  * #define FIREBASE_ASYNC_QUEUE_LIMIT 10
  * 
+ * 🏷️ For admitting the async requests by the memory in bytes that the queue holds instead of FIREBASE_ASYNC_QUEUE_LIMIT
+ * #define FIREBASE_ASYNC_QUEUE_MEM_BUDGET 16384
+ * 
+ * 🏷️ For the memory in bytes that is counted for each queued request in addition to its header and payload (default 1024)
+ * #define FIREBASE_SLOT_RESERVE_SIZE 1024
+ * 
+ * 🏷️ For the seconds to run the queue and wait for memory budget before the new request is rejected (default 0)
+ * #define FIREBASE_ASYNC_QUEUE_WAIT_SEC 0
+ * 
+ * 🏷️ For reusing the finished async slots and their String buffers when the kept text (bytes) is within this size
+ * #define FIREBASE_SLOT_ARENA_SIZE 4096
+ * 
+ * 🏷️ For maximum number of the finished async slots to keep for reuse (default 2)
+ * #define FIREBASE_SLOT_ARENA_COUNT 2
+ * 
+ * 🏷️ For the minimum size in bytes of the library buffer without allocation class hint to be placed in PSRAM (ESP32, default 1024)
+ * #define FIREBASE_PSRAM_MIN_SIZE 1024
+ * 
+ * 🏷️ For placing the malloc (and String) allocations of this size in bytes and larger in PSRAM (ESP32)
+ * #define FIREBASE_PSRAM_STRING_MIN_SIZE 4096
+ * 
+ * 🏷️ For number of the reusable I/O chunk buffers of an async client (default 2)
+ * #define FIREBASE_CHUNK_POOL_SIZE 2
+ * 
+ * 🏷️ For the upload and download progress percent step that emits the progress event (default 2)
+ * #define FIREBASE_PROGRESS_PERCENT 2
+ * 
+ * 🏷️ For the bytes transferred since the last progress event that also emit the event (default 0, percent step only)
+ * #define FIREBASE_PROGRESS_BYTES 65536
+ * 
+ * 🏷️ For the minimum interval in ms between the progress events (default 0)
+ * #define FIREBASE_PROGRESS_INTERVAL_MS 500
+ * 
+ * 🏷️ For emitting the 100 percent progress event regardless of the interval (default 1),
+ * when set to 0, the 100 percent event that comes within the interval is not emitted
+ * #define FIREBASE_PROGRESS_FINAL 1
+ * 
+ * 🏷️ For JWT token signing in the separate FreeRTOS task (ESP32) or thread (Linux)
+ * #define ENABLE_JWT_WORKER
+ * 
+ * 🏷️ For counting the library heap allocations per operation type via MemoryStats
+ * #define FIREBASE_MEMORY_STATS
+ * 
+ * 🏷️ For counting all heap allocations (including String) via the malloc interposer (core/MemoryInterpose.h)
+ * #define FIREBASE_MEMORY_STATS_INTERPOSE
+ * 
+ * 🏷️ For disabling the SIMD JSON scanning and Base64 decoding on host (x86/ARM64) targets
+ * #define FIREBASE_DISABLE_SIMD
+ * 
  * 🏷️ For Firebase.printf debug port
  * #define FIREBASE_PRINTF_PORT Serial
  */
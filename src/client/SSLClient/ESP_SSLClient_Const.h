@@ -45,6 +45,18 @@ enum esp_ssl_client_debug_level
     esp_ssl_debug_dump = 4
 };
 
+// The number of hosts that the Maximum Fragment Length negotiation result will be remembered.
+#if !defined(ESP_SSLCLIENT_MFLN_CACHE_SIZE)
+#define ESP_SSLCLIENT_MFLN_CACHE_SIZE 4
+#endif
+
+enum esp_ssl_client_mfln_status
+{
+    esp_ssl_mfln_unknown,
+    esp_ssl_mfln_supported,
+    esp_ssl_mfln_unsupported
+};
+
 enum esp_ssl_client_error_types
 {
     esp_ssl_ok,
@@ -2669,6 +2669,17 @@ struct br_ssl_client_context_ {
 	 * Implementations.
 	 */
 	br_rsa_public irsapub;
+
+	/*
+	 * Precomputed ECDHE key pair (private key and public point). It
+	 * is used (once) by the next handshake when the server selects
+	 * the same curve; ecdhe_pre_curve is 0 when not set.
+	 */
+	int ecdhe_pre_curve;
+	unsigned char ecdhe_pre_key[66];
+	size_t ecdhe_pre_key_len;
+	unsigned char ecdhe_pre_point[133];
+	size_t ecdhe_pre_point_len;
 #endif
 };
 
@@ -2844,6 +2855,39 @@ br_ssl_client_set_min_clienthello_len(br_ssl_client_context *cc, uint16_t len)
 	cc->min_clienthello_len = len;
 }
 
+/**
+ * \brief Set the precomputed ECDHE key pair.
+ *
+ * The key pair is used in place of a freshly generated one for the
+ * next ECDHE key exchange, if the server selects the same curve. It is
+ * used only once and cleared after use. The public point must be the
+ * product of the private key and the curve generator, in the format
+ * returned by the `mulgen()` method of the EC implementation.
+ *
+ * \param cc          client context.
+ * \param curve       curve identifier.
+ * \param key         private key (big-endian, same length as the curve order).
+ * \param key_len     private key length (in bytes, at most 66).
+ * \param point       public point.
+ * \param point_len   public point length (in bytes, at most 133).
+ */
+static inline void
+br_ssl_client_set_ecdhe_key(br_ssl_client_context *cc, int curve,
+	const unsigned char *key, size_t key_len,
+	const unsigned char *point, size_t point_len)
+{
+	if (key_len > sizeof cc->ecdhe_pre_key
+		|| point_len > sizeof cc->ecdhe_pre_point) {
+		cc->ecdhe_pre_curve = 0;
+		return;
+	}
+	memcpy(cc->ecdhe_pre_key, key, key_len);
+	cc->ecdhe_pre_key_len = key_len;
+	memcpy(cc->ecdhe_pre_point, point, point_len);
+	cc->ecdhe_pre_point_len = point_len;
+	cc->ecdhe_pre_curve = curve;
+}
+
 /**
  * \brief Prepare or reset a client context for a new connection.
  *
@@ -272,7 +272,9 @@ make_pms_ecdh(br_ssl_client_context *ctx, unsigned ecdhe, int prf_id)
 	const unsigned char *order, *point_src;
 	size_t glen, olen, point_len, xoff, xlen;
 	unsigned char mask;
+	int use_pre;
 
+	use_pre = 0;
 	if (ecdhe) {
 		curve = ctx->eng.ecdhe_curve;
 		point_src = ctx->eng.ecdhe_point;
@@ -298,13 +300,22 @@ make_pms_ecdh(br_ssl_client_context *ctx, unsigned ecdhe, int prf_id)
 	 * the value is in the proper range.
 	 */
 	order = ctx->eng.iec->order(curve, &olen);
-	mask = 0xFF;
-	while (mask >= order[0]) {
-		mask >>= 1;
+	if (ecdhe && ctx->ecdhe_pre_curve == curve
+		&& ctx->ecdhe_pre_key_len == olen) {
+		/*
+		 * Use the precomputed key pair (once).
+		 */
+		memcpy(key, ctx->ecdhe_pre_key, olen);
+		use_pre = 1;
+	} else {
+		mask = 0xFF;
+		while (mask >= order[0]) {
+			mask >>= 1;
+		}
+		br_hmac_drbg_generate(&ctx->eng.rng, key, olen);
+		key[0] &= mask;
+		key[olen - 1] |= 0x01;
 	}
-	br_hmac_drbg_generate(&ctx->eng.rng, key, olen);
-	key[0] &= mask;
-	key[olen - 1] |= 0x01;
 
 	/*
 	 * Compute the common ECDH point, whose X coordinate is the
@@ -326,7 +337,15 @@ make_pms_ecdh(br_ssl_client_context *ctx, unsigned ecdhe, int prf_id)
 	xoff = ctx->eng.iec->xoff(curve, &xlen);
 	br_ssl_engine_compute_master(&ctx->eng, prf_id, point + xoff, xlen);
 
-	ctx->eng.iec->mulgen(point, key, olen, curve);
+	if (use_pre && ctx->ecdhe_pre_point_len == glen) {
+		memcpy(point, ctx->ecdhe_pre_point, glen);
+	} else {
+		ctx->eng.iec->mulgen(point, key, olen, curve);
+	}
+	if (use_pre) {
+		memset(ctx->ecdhe_pre_key, 0, sizeof ctx->ecdhe_pre_key);
+		ctx->ecdhe_pre_curve = 0;
+	}
 	memcpy(ctx->eng.pad, point, glen);
 	return (int)glen;
 }
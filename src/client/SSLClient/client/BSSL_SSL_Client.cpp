@@ -151,6 +151,10 @@ uint8_t BSSL_SSL_Client::connected()
     if (!mIsClientInitialized(false))
         return 0;
 
+    // The TCP socket is opened but the SSL layer is not ready until poll() returns 1.
+    if (_handshake_pending)
+        return 0;
+
     if (!_secure)
         return _basic_client->connected();
 
@@ -276,6 +280,10 @@ size_t BSSL_SSL_Client::write(const uint8_t *buf, size_t size)
     if (!mIsClientInitialized(false))
         return 0;
 
+    // Don't write the plain data into the socket while the handshake is in progress.
+    if (_handshake_pending)
+        return 0;
+
     if (!_secure)
         return _basic_client->write(buf, size);
 
@@ -435,13 +443,16 @@ int BSSL_SSL_Client::connectSSL(IPAddress ip, uint16_t port)
     if (!mIsClientInitialized(true))
         return 0;
 
+    if (_auto_mfln)
+        mApplyMaxFragmentLength(nullptr, ip, port);
+
     if (!_basic_client->connected() && !mConnectBasicClient(nullptr, ip, port))
         return 0;
 
     _ip = ip;
     _port = port;
 
-    return mConnectSSL(nullptr);
+    return mConnectSSLAuto(nullptr, ip, port);
 }
 
 int BSSL_SSL_Client::connectSSL(const char *host, uint16_t port)
@@ -450,17 +461,112 @@ int BSSL_SSL_Client::connectSSL(const char *host, uint16_t port)
     if (!mIsClientInitialized(true))
         return 0;
 
+    if (_auto_mfln)
+        mApplyMaxFragmentLength(host, IPAddress(), port);
+
     if (!_basic_client->connected() && !mConnectBasicClient(host, IPAddress(), port))
         return 0;
 
     _host = host;
     _port = port;
 
-    return mConnectSSL(host);
+    return mConnectSSLAuto(host, IPAddress(), port);
+}
+
+int BSSL_SSL_Client::connectSSLStart(IPAddress ip, uint16_t port)
+{
+    _host.remove(0, _host.length());
+    _ip = ip;
+    _port = port;
+    return mConnectSSLStart(nullptr, ip, port);
+}
+
+int BSSL_SSL_Client::connectSSLStart(const char *host, uint16_t port)
+{
+    _host = host;
+    _port = port;
+    return mConnectSSLStart(_host.c_str(), IPAddress(), port);
+}
+
+int BSSL_SSL_Client::poll()
+{
+    if (!_handshake_pending)
+        return connected() ? 1 : -1;
+
+    const char *host = _host.length() ? _host.c_str() : nullptr;
+
+    // Only process what the socket has, this will not wait for the incoming data.
+    unsigned state = mUpdateEngine();
+
+    if (state == BR_SSL_CLOSED || getWriteError() != esp_ssl_ok || !_basic_client->connected())
+    {
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+        esp_ssl_debug_print(PSTR("Failed to initlalize the SSL layer."), _debug_level, esp_ssl_debug_error, __func__);
+        if (_sc)
+            mPrintSSLError(br_ssl_engine_last_error(_eng), esp_ssl_debug_error, __func__);
+#endif
+        _handshake_pending = false;
+        bool rejected = _sc && br_ssl_engine_last_error(_eng) == BR_ERR_TOO_LARGE;
+        mFreeSSL();
+
+        if (_auto_mfln && rejected && mFallbackMaxFragmentLength(host, _ip, _port, false) && mStartSSL(host))
+        {
+            _handshake_pending = true;
+            _handshake_start_ms = millis();
+            return 0;
+        }
+
+        return -1;
+    }
+
+    if (state & BR_SSL_SENDAPP || state & BR_SSL_RECVAPP)
+    {
+        _handshake_pending = false;
+        int ret = mFinishSSL();
+
+        if (_auto_mfln && _mfln_rejected)
+        {
+            if (mFallbackMaxFragmentLength(host, _ip, _port, true) && mStartSSL(host))
+            {
+                _handshake_pending = true;
+                _handshake_start_ms = millis();
+                return 0;
+            }
+            return -1;
+        }
+
+        if (_auto_mfln && ret > 0)
+            mCacheMaxFragmentLength(host, _ip, _port);
+
+        return ret;
+    }
+
+    if (millis() - _handshake_start_ms > _handshake_timeout)
+    {
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+        esp_ssl_debug_print(PSTR("SSL handshake timed out!"), _debug_level, esp_ssl_debug_error, __func__);
+#endif
+        _handshake_pending = false;
+        setWriteError(esp_ssl_write_error);
+        mFreeSSL();
+        _basic_client->stop();
+        return -1;
+    }
+
+    return 0;
 }
 
 void BSSL_SSL_Client::stop()
 {
+    if (_handshake_pending)
+    {
+        _handshake_pending = false;
+        mFreeSSL();
+        if (_basic_client)
+            _basic_client->stop();
+        return;
+    }
+
     if (!_secure)
         return;
 
@@ -522,6 +628,13 @@ void BSSL_SSL_Client::flush()
 }
 
 void BSSL_SSL_Client::setBufferSizes(int recv, int xmit)
+{
+    // Keep the requested transmit size for the automatic MFLN buffer sizes.
+    _xmit_size = xmit;
+    mSetBufferSizes(recv, xmit);
+}
+
+void BSSL_SSL_Client::mSetBufferSizes(int recv, int xmit)
 {
     // Following constants taken from bearssl/src/ssl/ssl_engine.c (not exported unfortunately)
     const int MAX_OUT_OVERHEAD = 85;
@@ -991,6 +1104,63 @@ bool BSSL_SSL_Client::probeMaxFragmentLength(const String &host, uint16_t port,
     return BSSL_SSL_Client::probeMaxFragmentLength(host.c_str(), port, len);
 }
 
+bool BSSL_SSL_Client::precomputeKeyShare()
+{
+#if defined(USE_LIB_SSL_ENGINE)
+    // Already available
+    if (_ecdhe_pre_curve > 0)
+        return false;
+
+    const br_ec_impl *iec = br_ec_get_default();
+    if ((iec->supported_curves & ((uint32_t)1 << _ecdhe_curve)) == 0)
+        return false;
+
+    size_t olen = 0;
+    const unsigned char *order = iec->order(_ecdhe_curve, &olen);
+    if (olen > sizeof(_ecdhe_pre_key))
+        return false;
+
+    // Seed the DRBG in the same way as the SSL engine.
+    uint8_t rng_seeds[32];
+    for (uint8_t i = 0; i < sizeof rng_seeds; i++)
+        rng_seeds[i] = static_cast<uint8_t>(random(256));
+
+    br_hmac_drbg_context rng;
+    br_hmac_drbg_init(&rng, &br_sha256_vtable, rng_seeds, sizeof rng_seeds);
+    br_prng_seeder seeder = br_prng_seeder_system(nullptr);
+    if (seeder)
+        seeder(&rng.vtable);
+
+    // The private key generation is the same as in the handshake (make_pms_ecdh).
+    unsigned char mask = 0xFF;
+    while (mask >= order[0])
+        mask >>= 1;
+    br_hmac_drbg_generate(&rng, _ecdhe_pre_key, olen);
+    _ecdhe_pre_key[0] &= mask;
+    _ecdhe_pre_key[olen - 1] |= 0x01;
+    _ecdhe_pre_key_len = olen;
+
+    _ecdhe_pre_point_len = iec->mulgen(_ecdhe_pre_point, _ecdhe_pre_key, olen, _ecdhe_curve);
+    memset(rng_seeds, 0, sizeof rng_seeds);
+    memset(&rng, 0, sizeof rng);
+
+    if (_ecdhe_pre_point_len == 0)
+        return false;
+
+    _ecdhe_pre_curve = _ecdhe_curve;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void BSSL_SSL_Client::setAutoMaxFragmentLength(bool enable, uint16_t len)
+{
+    _auto_mfln = enable;
+    // Only 512, 1024, 2048 and 4096 are allowed by the spec.
+    _auto_mfln_len = len >= 4096 ? 4096 : (len >= 2048 ? 2048 : (len >= 1024 ? 1024 : 512));
+}
+
 size_t BSSL_SSL_Client::peekAvailable()
 {
     return available();
@@ -1133,6 +1303,42 @@ void BSSL_SSL_Client::setSecure(const char *rootCABuff, const char *cli_cert, co
 // Private access
 //////////////////////////////////////////////////////
 
+// The Maximum Fragment Length negotiation results, shared by all clients.
+struct bssl_mfln_cache_item_t
+{
+    uint32_t key = 0;
+    uint8_t status = esp_ssl_mfln_unknown;
+};
+
+static bssl_mfln_cache_item_t bssl_mfln_cache[ESP_SSLCLIENT_MFLN_CACHE_SIZE];
+static uint8_t bssl_mfln_cache_index = 0;
+
+static uint8_t bssl_mfln_cache_get(uint32_t key)
+{
+    for (uint8_t i = 0; i < ESP_SSLCLIENT_MFLN_CACHE_SIZE; i++)
+    {
+        if (bssl_mfln_cache[i].key == key)
+            return bssl_mfln_cache[i].status;
+    }
+    return esp_ssl_mfln_unknown;
+}
+
+static void bssl_mfln_cache_set(uint32_t key, uint8_t status)
+{
+    for (uint8_t i = 0; i < ESP_SSLCLIENT_MFLN_CACHE_SIZE; i++)
+    {
+        if (bssl_mfln_cache[i].key == key)
+        {
+            bssl_mfln_cache[i].status = status;
+            return;
+        }
+    }
+    // Replace the oldest item
+    bssl_mfln_cache[bssl_mfln_cache_index].key = key;
+    bssl_mfln_cache[bssl_mfln_cache_index].status = status;
+    bssl_mfln_cache_index = (bssl_mfln_cache_index + 1) % ESP_SSLCLIENT_MFLN_CACHE_SIZE;
+}
+
 bool BSSL_SSL_Client::mProbeMaxFragmentLength(Client *probe, uint16_t len)
 {
 
@@ -1438,6 +1644,33 @@ bool BSSL_SSL_Client::mSoftConnected(const char *func_name)
 }
 
 int BSSL_SSL_Client::mConnectSSL(const char *host)
+{
+    if (!mStartSSL(host))
+        return 0;
+
+// SSL/TLS handshake
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+    esp_ssl_debug_print(PSTR("Wait for SSL handshake."), _debug_level, esp_ssl_debug_info, __func__);
+#endif
+
+    if (mRunUntil(BR_SSL_SENDAPP, _handshake_timeout) < 0)
+    {
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+        esp_ssl_debug_print(PSTR("Failed to initlalize the SSL layer."), _debug_level, esp_ssl_debug_error, __func__);
+        if (_sc)
+            mPrintSSLError(br_ssl_engine_last_error(_eng), esp_ssl_debug_error, __func__);
+#endif
+        // The record is larger than the receive buffer, the server ignored the MFLN.
+        if (_sc && br_ssl_engine_last_error(_eng) == BR_ERR_TOO_LARGE)
+            _mfln_rejected = true;
+        mFreeSSL();
+        return 0;
+    }
+
+    return mFinishSSL();
+}
+
+int BSSL_SSL_Client::mStartSSL(const char *host)
 {
 
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
@@ -1553,20 +1786,30 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
         return 0;
     }
 
-// SSL/TLS handshake
-#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
-    esp_ssl_debug_print(PSTR("Wait for SSL handshake."), _debug_level, esp_ssl_debug_info, __func__);
+#if defined(USE_LIB_SSL_ENGINE)
+    // Use the precomputed ECDHE key pair (once).
+    if (_ecdhe_pre_curve > 0)
+    {
+        br_ssl_client_set_ecdhe_key(_sc.get(), _ecdhe_pre_curve, _ecdhe_pre_key, _ecdhe_pre_key_len, _ecdhe_pre_point, _ecdhe_pre_point_len);
+        memset(_ecdhe_pre_key, 0, sizeof(_ecdhe_pre_key));
+        _ecdhe_pre_curve = 0;
+    }
 #endif
 
-    if (mRunUntil(BR_SSL_SENDAPP, _handshake_timeout) < 0)
-    {
-#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
-        esp_ssl_debug_print(PSTR("Failed to initlalize the SSL layer."), _debug_level, esp_ssl_debug_error, __func__);
-        mPrintSSLError(br_ssl_engine_last_error(_eng), esp_ssl_debug_error, __func__);
+    return 1;
+}
+
+int BSSL_SSL_Client::mFinishSSL()
+{
+    // The smaller receive buffer is usable only when MFLN was negotiated.
+    if (_iobuf_in_size < 16384 && !br_ssl_engine_get_mfln_negotiated(_eng))
+        _mfln_rejected = true;
+
+#if defined(USE_LIB_SSL_ENGINE)
+    // Keep the server selected curve for the next key pair precomputation.
+    if (br_ssl_engine_get_ecdhe_curve(_eng) > 0)
+        _ecdhe_curve = br_ssl_engine_get_ecdhe_curve(_eng);
 #endif
-        mFreeSSL();
-        return 0;
-    }
 
 #if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
     esp_ssl_debug_print(PSTR("Connection successful!"), _debug_level, esp_ssl_debug_info, __func__);
@@ -1587,6 +1830,118 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
     return 1;
 }
 
+void BSSL_SSL_Client::mApplyMaxFragmentLength(const char *host, IPAddress ip, uint16_t port)
+{
+    uint8_t status = bssl_mfln_cache_get(mHostKey(host, ip, port));
+
+    // The first handshake to the host requests the MFLN, the server that ignores it is handled by mFallbackMaxFragmentLength.
+    if (status == esp_ssl_mfln_unsupported)
+        mSetBufferSizes(16384, _xmit_size);
+    else
+        mSetBufferSizes(_auto_mfln_len, _auto_mfln_len);
+}
+
+void BSSL_SSL_Client::mCacheMaxFragmentLength(const char *host, IPAddress ip, uint16_t port)
+{
+    // The ignored MFLN was already remembered by mFallbackMaxFragmentLength.
+    if (!br_ssl_engine_get_mfln_negotiated(_eng))
+        return;
+
+    bssl_mfln_cache_set(mHostKey(host, ip, port), esp_ssl_mfln_supported);
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+    esp_ssl_debug_print(PSTR("MFLN is supported."), _debug_level, esp_ssl_debug_info, __func__);
+#endif
+}
+
+int BSSL_SSL_Client::mConnectSSLAuto(const char *host, IPAddress ip, uint16_t port)
+{
+    _mfln_rejected = false;
+
+    int ret = mConnectSSL(host);
+
+    if (!_auto_mfln)
+        return ret;
+
+    if (!_mfln_rejected)
+    {
+        if (ret > 0)
+            mCacheMaxFragmentLength(host, ip, port);
+        return ret;
+    }
+
+    return mFallbackMaxFragmentLength(host, ip, port, ret > 0) ? mConnectSSL(host) : 0;
+}
+
+bool BSSL_SSL_Client::mFallbackMaxFragmentLength(const char *host, IPAddress ip, uint16_t port, bool secured)
+{
+    // The server ignored the MFLN request, remember it and reconnect with the full size receive buffer.
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+    esp_ssl_debug_print(PSTR("MFLN was ignored by server, reconnect with full size buffer."), _debug_level, esp_ssl_debug_warn, __func__);
+#endif
+    bssl_mfln_cache_set(mHostKey(host, ip, port), esp_ssl_mfln_unsupported);
+    _mfln_rejected = false;
+
+    if (secured)
+        stop();
+    else if (_basic_client->connected())
+        _basic_client->stop();
+
+    mSetBufferSizes(16384, _xmit_size);
+    setWriteError(esp_ssl_ok);
+
+    return mConnectBasicClient(host, ip, port);
+}
+
+int BSSL_SSL_Client::mConnectSSLStart(const char *host, IPAddress ip, uint16_t port)
+{
+    _handshake_pending = false;
+
+    if (!mIsClientInitialized(true))
+        return 0;
+
+    // Not a secure connection, nothing to wait.
+    if (!_isSSLEnabled || !mIsSecurePort(port))
+        return mConnectBasicClient(host, ip, port);
+
+    if (_auto_mfln)
+        mApplyMaxFragmentLength(host, ip, port);
+
+    if (!_basic_client->connected() && !mConnectBasicClient(host, ip, port))
+        return 0;
+
+    _mfln_rejected = false;
+
+    if (!mStartSSL(host))
+        return 0;
+
+#if defined(ESP_SSLCLIENT_ENABLE_DEBUG)
+    esp_ssl_debug_print(PSTR("SSL handshake started."), _debug_level, esp_ssl_debug_info, __func__);
+#endif
+
+    _handshake_pending = true;
+    _handshake_start_ms = millis();
+    return 1;
+}
+
+uint32_t BSSL_SSL_Client::mHostKey(const char *host, IPAddress ip, uint16_t port)
+{
+    // FNV-1a hash of host name (case insensitive) or IP, and port
+    uint32_t h = 2166136261UL;
+    if (host)
+    {
+        for (const char *p = host; *p; p++)
+            h = (h ^ (uint8_t)tolower(*p)) * 16777619UL;
+    }
+    else
+    {
+        for (uint8_t i = 0; i < 4; i++)
+            h = (h ^ ip[i]) * 16777619UL;
+    }
+    h = (h ^ (port & 0xff)) * 16777619UL;
+    h = (h ^ (port >> 8)) * 16777619UL;
+    return h ? h : 1;
+}
+
 bool BSSL_SSL_Client::mConnectionValidate(const char *host, IPAddress ip, uint16_t port)
 {
     if (!mIsClientInitialized(true))
@@ -2104,6 +2459,11 @@ bool BSSL_SSL_Client::mInstallClientX509Validator()
 
 void BSSL_SSL_Client::mFreeSSL()
 {
+#if defined(USE_LIB_SSL_ENGINE)
+    // Clear the unused precomputed ECDHE private key.
+    if (_sc)
+        memset(_sc->ecdhe_pre_key, 0, sizeof(_sc->ecdhe_pre_key));
+#endif
     // These are smart pointers and will free if refcnt==0
     _sc = nullptr;
     _x509_minimal = nullptr;
@@ -128,6 +128,12 @@ public:
 
     int connectSSL(const char *host, uint16_t port);
 
+    int connectSSLStart(IPAddress ip, uint16_t port);
+
+    int connectSSLStart(const char *host, uint16_t port);
+
+    int poll();
+
     void stop() override;
 
     void setTimeout(unsigned int timeoutMs);
@@ -180,6 +186,10 @@ public:
 
     bool probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len);
 
+    void setAutoMaxFragmentLength(bool enable, uint16_t len = 4096);
+
+    bool precomputeKeyShare();
+
     size_t peekAvailable();
 
     const char *peekBuffer();
@@ -238,6 +248,31 @@ private:
 
     int mConnectSSL(const char *host = nullptr);
 
+    // Sets up the SSL engine and starts the handshake without waiting.
+    int mStartSSL(const char *host);
+
+    // Keeps the connection state when the handshake completed.
+    int mFinishSSL();
+
+    int mConnectSSLStart(const char *host, IPAddress ip, uint16_t port);
+
+    // Sets the I/O buffer sizes with the SSL overhead, the requested sizes are not changed.
+    void mSetBufferSizes(int recv, int xmit);
+
+    // Applies the remembered Maximum Fragment Length support of the host to the I/O buffer sizes.
+    void mApplyMaxFragmentLength(const char *host, IPAddress ip, uint16_t port);
+
+    // Remembers the MFLN support of the host from the completed handshake.
+    void mCacheMaxFragmentLength(const char *host, IPAddress ip, uint16_t port);
+
+    // Connects the SSL layer and reconnects with the full size receive buffer when the server ignored MFLN.
+    int mConnectSSLAuto(const char *host, IPAddress ip, uint16_t port);
+
+    // Remembers that the server ignored MFLN and reconnects the basic client for the full size receive buffer.
+    bool mFallbackMaxFragmentLength(const char *host, IPAddress ip, uint16_t port, bool secured);
+
+    uint32_t mHostKey(const char *host, IPAddress ip, uint16_t port);
+
     bool mConnectionValidate(const char *host, IPAddress ip, uint16_t port);
 
     int mRunUntil(const unsigned target, unsigned long timeout = 0);
@@ -296,6 +331,7 @@ private:
     unsigned char *_iobuf_in = nullptr;
     unsigned char *_iobuf_out = nullptr;
     int _iobuf_in_size = 512;
+    int _xmit_size = 512; // The requested transmit buffer size without the SSL overhead.
     int _iobuf_out_size = 512;
 
     time_t _now = 0;
@@ -338,6 +374,20 @@ private:
     size_t _recvapp_len;
     unsigned long _timeout = 15000;
     unsigned long _handshake_timeout = 60000;
+    bool _auto_mfln = false;
+    uint16_t _auto_mfln_len = 4096;
+    bool _mfln_rejected = false;
+    bool _handshake_pending = false;
+#if defined(USE_LIB_SSL_ENGINE)
+    // The precomputed ECDHE key pair for the next handshake.
+    int _ecdhe_curve = BR_EC_secp256r1;
+    int _ecdhe_pre_curve = 0;
+    unsigned char _ecdhe_pre_key[66];
+    size_t _ecdhe_pre_key_len = 0;
+    unsigned char _ecdhe_pre_point[133];
+    size_t _ecdhe_pre_point_len = 0;
+#endif
+    unsigned long _handshake_start_ms = 0;
     bool _isSSLEnabled = false;
     String _host;
     uint16_t _port = 0;
@@ -260,6 +260,21 @@ bool BSSL_TCP_Client::connectSSL()
 
 bool BSSL_TCP_Client::connectSSL(const String host, uint16_t port) { return connectSSL(); }
 
+int BSSL_TCP_Client::connectSSLStart(IPAddress ip, uint16_t port)
+{
+    _port = port;
+    return _ssl_client.connectSSLStart(ip, port);
+}
+
+int BSSL_TCP_Client::connectSSLStart(const char *host, uint16_t port)
+{
+    _host = host;
+    _port = port;
+    return _ssl_client.connectSSLStart(host, port);
+}
+
+int BSSL_TCP_Client::poll() { return _ssl_client.poll(); }
+
 void BSSL_TCP_Client::stop()
 {
     _ssl_client.stop();
@@ -378,6 +393,10 @@ bool BSSL_TCP_Client::probeMaxFragmentLength(const char *hostname, uint16_t port
 
 bool BSSL_TCP_Client::probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len) { return _ssl_client.probeMaxFragmentLength(host, port, len); };
 
+void BSSL_TCP_Client::setAutoMaxFragmentLength(bool enable, uint16_t len) { _ssl_client.setAutoMaxFragmentLength(enable, len); }
+
+bool BSSL_TCP_Client::precomputeKeyShare() { return _ssl_client.precomputeKeyShare(); }
+
 // peek buffer API is present
 bool BSSL_TCP_Client::hasPeekBufferAPI() const { return true; }
 
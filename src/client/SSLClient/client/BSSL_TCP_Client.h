@@ -294,6 +294,30 @@ public:
      */
     bool connectSSL(const String host, uint16_t port);
 
+    /**
+     * Connect to server and start the SSL handshake without waiting for it to finish.
+     * The handshake will be processed by calling poll() until it returns 1 (completed) or -1 (failure).
+     * @param ip The server IP to connect.
+     * @param port The server port to connect.
+     * @return 1 for success or 0 for failure.
+     */
+    int connectSSLStart(IPAddress ip, uint16_t port);
+
+    /**
+     * Connect to server and start the SSL handshake without waiting for it to finish.
+     * The handshake will be processed by calling poll() until it returns 1 (completed) or -1 (failure).
+     * @param host The server host name.
+     * @param port The server port to connect.
+     * @return 1 for success or 0 for failure.
+     */
+    int connectSSLStart(const char *host, uint16_t port);
+
+    /**
+     * Process the SSL handshake that started by connectSSLStart() with the data that is currently available.
+     * @return 1 for handshake completed, 0 for handshake in progress or -1 for failure or timed out.
+     */
+    int poll();
+
     /**
      * Stop the TCP connection and release resources.
      */
@@ -377,6 +401,26 @@ public:
 
     bool probeMaxFragmentLength(const String &host, uint16_t port, uint16_t len);
 
+    /**
+     * Enable or disable the automatic Maximum Fragment Length negotiation.
+     * When enabled, the I/O buffer sizes are set to the maximum fragment length and the MFLN is requested in the handshake,
+     * the support of the server is taken from the first handshake to the host and port (no extra probe connection) and remembered.
+     * The full size (16k) receive buffer will be used when the server does not support or ignores the MFLN,
+     * the first connection to that server is reconnected once.
+     * @param enable The boolean option to enable.
+     * @param len The maximum fragment length (512, 1024, 2048 or 4096).
+     */
+    void setAutoMaxFragmentLength(bool enable, uint16_t len = 4096);
+
+    /**
+     * Precompute the ECDHE key pair for the next SSL handshake.
+     * The key pair will be computed for the curve that was selected by server in the last handshake (secp256r1 by default)
+     * and will be used once when the server selects the same curve.
+     * This should be called when the client is idle to reduce the SSL handshake time.
+     * @return true when the new key pair was computed, false when it is already available or not supported.
+     */
+    bool precomputeKeyShare();
+
     bool hasPeekBufferAPI() const;
 
     size_t peekAvailable();
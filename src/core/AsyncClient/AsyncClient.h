@@ -40,6 +40,7 @@
 #include "./core/List.h"
 #include "./core/Core.h"
 #include "./core/URL.h"
+#include "./core/IdleQueue.h"
 
 #if defined(ENABLE_ASYNC_TCP_CLIENT)
 #include "./core/AsyncTCPConfig.h"
@@ -47,9 +48,28 @@
 
 using namespace firebase;
 
+/**
+ * TCP Client Non-Blocking Connection Request Callback.
+ * @param host The host to connect.
+ * @param port The port to connect.
+ * @return 1 when the connection was started or 0 for failure.
+ *
+ * The TCP client should start the server connection (and SSL handshake) without waiting for it to finish.
+ */
+typedef int (*TCPConnectStart)(const char *host, uint16_t port);
+
+/**
+ * TCP Client Non-Blocking Connection Poll Callback.
+ * @return 1 for connected, 0 for connection in progress or -1 for failure.
+ *
+ * The TCP client should process the connection (and SSL handshake) only with the data that is currently available.
+ */
+typedef int (*TCPConnectPoll)();
+
 enum async_state
 {
     async_state_undefined,
+    async_state_connect,
     async_state_send_header,
     async_state_send_payload,
     async_state_read_response,
@@ -98,6 +118,9 @@ public:
     uint32_t ref_result_addr = 0;
     AsyncResultCallback cb = NULL;
     Timer err_timer;
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+    bool payload_swapped = false; // The result payload buffer was swapped in from the user result.
+#endif
     async_data_item_t()
     {
         addr = reinterpret_cast<uint32_t>(this);
@@ -135,6 +158,41 @@ public:
         cb = NULL;
         err_timer.reset();
     }
+
+    // Get the length of text that was kept in the request, response and result buffers.
+    // The request and response buffers are counted with the largest text they held, their capacity is kept after clearing.
+    size_t textSize()
+    {
+        size_t size = request.location.length() + request.bufSize() + response.bufSize();
+        for (size_t i = 0; i < ares_ns::max_type; i++)
+            size += aResult.val[i].length();
+        return size;
+    }
+
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+    // Reset all states for the next request, the String buffers keep their capacity.
+    void recycle()
+    {
+        reset();
+        // The capacity of the swapped in payload buffer is unknown, it is released.
+        if (payload_swapped)
+        {
+            aResult.val[ares_ns::data_payload] = String();
+            payload_swapped = false;
+        }
+        request.location.remove(0, request.location.length());
+        request.app_token = nullptr;
+        response.auth_data_available = false;
+        download = false;
+        upload = false;
+        upload_progress_enabled = false;
+        auth_ts = 0;
+        aResult.clear();
+        refResult = nullptr;
+        ref_result_addr = 0;
+        err_timer.feed(0);
+    }
+#endif
 };
 
 struct slot_options_t
@@ -148,6 +206,7 @@ public:
     bool no_etag = false;
     bool auth_param = false;
     app_token_t *app_token = nullptr;
+    size_t payload_size = 0; // The size of payload to be kept in memory for admission control.
     slot_options_t() {}
     slot_options_t(bool auth_used, bool sse, bool async, bool sv, bool ota, bool no_etag, bool auth_param = false)
     {
@@ -191,12 +250,20 @@ private:
     String host;
     uint16_t port;
     std::vector<uint32_t> sVec;
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+    std::vector<uint32_t> spareVec;
+#endif
     Memory mem;
+    ChunkPool pool{FIREBASE_CHUNK_SIZE};
     Base64Util but;
     network_config_data net;
     uint32_t addr = 0;
     bool inProcess = false;
     bool inStopAsync = false;
+    IdleQueue idleQueue;
+    TCPConnectStart tcp_connect_start = NULL;
+    TCPConnectPoll tcp_connect_poll = NULL;
+    bool tcp_connecting = false;
 
     void closeFile(async_data_item_t *sData)
     {
@@ -293,6 +360,7 @@ private:
         int toSend = 0;
         if (sData->request.file_data.filename.length() > 0 ? sData->request.file_data.file.available() : sData->request.file_data.data_pos < sData->request.file_data.data_size)
         {
+            FIREBASE_MEM_STATS_SCOPE(mem_op_upload_chunk);
             if (sData->request.base64)
             {
 
@@ -309,7 +377,7 @@ private:
                         toSend = sData->request.file_data.data_size - sData->request.file_data.data_pos;
                 }
 
-                buf = reinterpret_cast<uint8_t *>(mem.alloc(toSend));
+                buf = reinterpret_cast<uint8_t *>(pool.alloc(toSend));
                 if (sData->request.file_data.filename.length() > 0)
                 {
                     toSend = sData->request.file_data.file.read(buf, toSend);
@@ -326,9 +394,9 @@ private:
                     sData->request.file_data.data_pos += toSend;
                 }
 
-                uint8_t *temp = (uint8_t *)but.encodeToChars(mem, buf, toSend);
-                mem.release(&buf);
-                toSend = strlen((char *)temp);
+                uint8_t *temp = reinterpret_cast<uint8_t *>(pool.alloc(but.encodedLength(toSend) + 1));
+                toSend = but.encodeToChars((char *)temp, buf, toSend);
+                pool.release(&buf);
                 buf = temp;
             }
             else
@@ -342,7 +410,7 @@ private:
 #endif
                     toSend = totalLen - sData->request.file_data.data_pos < FIREBASE_CHUNK_SIZE ? totalLen - sData->request.file_data.data_pos : FIREBASE_CHUNK_SIZE;
 
-                buf = reinterpret_cast<uint8_t *>(mem.alloc(toSend));
+                buf = reinterpret_cast<uint8_t *>(pool.alloc(toSend));
 
                 if (sData->request.file_data.filename.length() > 0)
                 {
@@ -370,12 +438,63 @@ private:
     exit:
 
         if (buf)
-            mem.release(&buf);
+            pool.release(&buf);
 #endif
 
         return ret;
     }
 
+    struct writer_sink_t
+    {
+        AsyncClientClass *client = nullptr;
+        async_data_item_t *sData = nullptr;
+        size_t sent = 0;
+        function_return_type ret = function_return_type_continue;
+    };
+
+    static bool writerFlush(void *arg, uint8_t *data, size_t len)
+    {
+        writer_sink_t *sink = reinterpret_cast<writer_sink_t *>(arg);
+        async_data_item_t *sData = sink->sData;
+
+        // The content that is longer than the calculated length can't be sent.
+        if (sink->ret != function_return_type_continue || sink->sent + len > sData->request.writer_len)
+        {
+            // The request was already sent with the calculated length.
+            if (sink->ret == function_return_type_complete)
+            {
+                sData->state = async_state_send_payload;
+                sink->client->setAsyncError(sData, sData->state, FIREBASE_ERROR_TCP_SEND, !sData->sse, false);
+                sink->ret = function_return_type_failure;
+            }
+            else if (sink->ret == function_return_type_continue)
+                sink->ret = sink->client->send(sData, nullptr, 0, sData->request.writer_len);
+            return false;
+        }
+
+        sink->sent += len;
+        sink->ret = sink->client->send(sData, data, len, sData->request.writer_len);
+        return sink->ret != function_return_type_failure;
+    }
+
+    function_return_type sendWriter(async_data_item_t *sData)
+    {
+        // Write the whole content in one pass, each chunk is sent as soon as it is full.
+        uint8_t *buf = reinterpret_cast<uint8_t *>(pool.alloc(FIREBASE_CHUNK_SIZE));
+        writer_sink_t sink;
+        sink.client = this;
+        sink.sData = sData;
+        JSONWriter writer;
+        writer.write(sData->request.writer_cb, buf, FIREBASE_CHUNK_SIZE, writerFlush, &sink);
+        pool.release(&buf);
+
+        // The content is shorter than the calculated length.
+        if (sink.ret == function_return_type_continue)
+            sink.ret = send(sData, nullptr, 0, sData->request.writer_len);
+
+        return sink.ret;
+    }
+
     function_return_type send(async_data_item_t *sData, const char *data, async_state state = async_state_send_payload)
     {
         return send(sData, (uint8_t *)data, data ? strlen(data) : 0, data ? strlen(data) : 0, state);
@@ -502,17 +621,21 @@ private:
 
         function_return_type ret = function_return_type_continue;
 
-        if (sData->state == async_state_undefined || sData->state == async_state_send_header)
+        if (sData->state == async_state_undefined || sData->state == async_state_connect || sData->state == async_state_send_header)
         {
             newCon(sData, getHost(sData, true).c_str(), sData->request.port);
 
-            if ((client_type == async_request_handler_t::tcp_client_type_sync && !client->connected()) || client_type == async_request_handler_t::tcp_client_type_async)
+            // The non-blocking connection is kept polling until the SSL handshake is done.
+            if ((client_type == async_request_handler_t::tcp_client_type_sync && (tcp_connecting || !client->connected())) || client_type == async_request_handler_t::tcp_client_type_async)
             {
                 ret = connect(sData, getHost(sData, true).c_str(), sData->request.port);
 
                 // allow non-blocking async tcp connection
                 if (ret == function_return_type_continue)
+                {
+                    sData->state = async_state_connect;
                     return ret;
+                }
 
                 if (ret != function_return_type_complete)
                     return connErrorHandler(sData, sData->state);
@@ -551,6 +674,8 @@ private:
             {
                 if (sData->request.val[req_hndlr_ns::payload].length())
                     ret = send(sData, sData->request.val[req_hndlr_ns::payload].c_str());
+                else if (sData->request.writer_cb)
+                    ret = sendWriter(sData);
                 else if (sData->upload)
                 {
                     if (sData->request.data && sData->request.dataLen)
@@ -590,7 +715,7 @@ private:
 
             if (connect(sData, host.c_str(), sData->request.port) > function_return_type_failure)
             {
-                sData->request.val[req_hndlr_ns::payload].remove(0, sData->request.val[req_hndlr_ns::payload].length());
+                sData->request.clearPayload();
                 sData->request.file_data.resumable.getHeader(sData->request.val[req_hndlr_ns::header], host, ext);
                 sData->state = async_state_send_header;
                 sData->request.file_data.resumable.setHeaderState();
@@ -611,7 +736,7 @@ private:
             {
                 URLUtil uut;
                 uut.relocate(sData->request.val[req_hndlr_ns::header], host, ext);
-                sData->request.val[req_hndlr_ns::payload].remove(0, sData->request.val[req_hndlr_ns::payload].length());
+                sData->request.clearPayload();
                 sData->state = async_state_send_header;
                 return function_return_type_continue;
             }
@@ -659,7 +784,16 @@ private:
 
     async_data_item_t *addSlot(int index = -1)
     {
-        async_data_item_t *sData = new async_data_item_t();
+        async_data_item_t *sData = nullptr;
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+        if (spareVec.size())
+        {
+            sData = reinterpret_cast<async_data_item_t *>(spareVec.back());
+            spareVec.pop_back();
+        }
+        else
+#endif
+            sData = new async_data_item_t();
         if (index > -1)
             sVec.insert(sVec.begin() + index, sData->addr);
         else
@@ -689,22 +823,18 @@ private:
 
         if (getResult(sData))
         {
-            if (setData || error_notify_timeout || download_status || upload_status)
+            // The slot payload is not read by the callback, it can be swapped into the result.
+            if (setData || error_notify_timeout)
             {
-                uint32_t ms = sData->refResult->last_debug_ms;
-                *sData->refResult = sData->aResult;
-                // Restore last debug ms after.
-                sData->refResult->last_debug_ms = ms;
-
-                if (setData)
-                    sData->refResult->setPayload(sData->aResult.val[ares_ns::data_payload]);
-
-                if (sData->aResult.download_data.downloaded == 0 || sData->aResult.upload_data.uploaded == 0)
-                {
-                    sData->refResult->setETag(sData->aResult.val[ares_ns::res_etag]);
-                    sData->refResult->setPath(sData->aResult.val[ares_ns::data_path]);
-                }
+                bool swap = !sData->cb || sData->auth_used;
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+                if (setData && swap)
+                    sData->payload_swapped = true;
+#endif
+                sData->refResult->setResult(sData->aResult, setData, swap);
             }
+            else if (download_status || upload_status)
+                sData->refResult->setProgress(sData->aResult);
         }
 
         if (sData->cb && (setData || error_notify_timeout || download_status || upload_status))
@@ -1030,10 +1160,13 @@ private:
                 {
                     if (sData->download)
                     {
+                        FIREBASE_MEM_STATS_SCOPE(mem_op_download_chunk);
                         if (sData->response.payloadLen)
                         {
                             if (sData->response.payloadRead == 0)
                             {
+                                sData->response.b64.reset();
+
                                 if (sData->request.ota)
                                 {
                                     otaut.prepareDownloadOTA(sData->response.payloadLen, sData->request.base64, sData->request.ota_error);
@@ -1059,49 +1192,29 @@ private:
                                     sData->request.file_data.outB.init(sData->request.file_data.data, sData->request.file_data.data_size);
                             }
 
-                            int toRead = 0, read = 0;
-                            uint8_t ofs = 0;
-
-                            buf = asyncBase64Buffer(sData, mem, read, toRead);
-
-                            if (sData->response.toFillLen)
-                                return true;
-
-                            if (!buf)
-                            {
-                                ofs = sData->request.base64 && sData->response.payloadRead == 0 ? 1 : 0;
-                                toRead = (int)(sData->response.payloadLen - sData->response.payloadRead) > FIREBASE_CHUNK_SIZE + ofs ? FIREBASE_CHUNK_SIZE + ofs : sData->response.payloadLen - sData->response.payloadRead;
-                                buf = reinterpret_cast<uint8_t *>(mem.alloc(toRead));
-                                read = sData->response.tcpRead(client_type, client, async_tcp_config, buf, toRead);
-                            }
+                            int toRead = (int)(sData->response.payloadLen - sData->response.payloadRead) > FIREBASE_CHUNK_SIZE ? FIREBASE_CHUNK_SIZE : sData->response.payloadLen - sData->response.payloadRead;
+                            buf = reinterpret_cast<uint8_t *>(pool.alloc(toRead));
+                            int read = sData->response.tcpRead(client_type, client, async_tcp_config, buf, toRead);
 
                             if (read > 0)
                             {
-                                if (sData->request.base64 && read < toRead)
-                                {
-                                    sData->response.toFillIndex += read;
-                                    sData->response.toFillLen = toRead - read;
-                                    sData->response.toFill = reinterpret_cast<uint8_t *>(mem.alloc(toRead));
-                                    memcpy(sData->response.toFill, buf, read);
-                                    goto exit;
-                                }
-
                                 sData->response.payloadRead += read;
                                 if (sData->request.base64)
                                 {
-                                    otaut.getPad(buf + ofs, read, sData->request.b64Pad);
+                                    // The Base64 string is decoded as it arrives, its quotes are skipped by the decoder.
+                                    bool last = sData->response.payloadRead >= sData->response.payloadLen;
                                     if (sData->request.ota)
                                     {
-                                        otaut.decodeBase64OTA(mem, &but, (const char *)buf, read - ofs, sData->request.ota_error);
+                                        otaut.decodeBase64OTA(mem, &but, sData->response.b64, (const char *)buf, read, last, sData->request.ota_error);
                                         if (sData->request.ota_error != 0)
                                         {
                                             setAsyncError(sData, async_state_read_response, sData->request.ota_error, !sData->sse, false);
                                             goto exit;
                                         }
 
-                                        if (sData->request.b64Pad > -1)
+                                        if (last)
                                         {
-                                            otaut.endDownloadOTA(sData->request.b64Pad, sData->request.ota_error);
+                                            otaut.endDownloadOTA(sData->response.b64.pad(), sData->request.ota_error);
                                             if (sData->request.ota_error != 0)
                                             {
                                                 setAsyncError(sData, async_state_read_response, sData->request.ota_error, !sData->sse, false);
@@ -1113,7 +1226,7 @@ private:
                                     else if (sData->request.file_data.filename.length() && sData->request.file_data.cb)
                                     {
 
-                                        if (!but.decodeToFile(mem, sData->request.file_data.file, (const char *)buf + ofs))
+                                        if (!but.decodeToFile(mem, sData->response.b64, sData->request.file_data.file, (const char *)buf, read, last))
                                         {
                                             setAsyncError(sData, async_state_read_response, FIREBASE_ERROR_FILE_WRITE, !sData->sse, true);
                                             goto exit;
@@ -1121,7 +1234,7 @@ private:
                                     }
 #endif
                                     else
-                                        but.decodeToBlob(mem, &sData->request.file_data.outB, (const char *)buf + ofs);
+                                        but.decodeToBlob(mem, sData->response.b64, &sData->request.file_data.outB, (const char *)buf, read, last);
                                 }
                                 else
                                 {
@@ -1171,15 +1284,14 @@ private:
     exit:
 
         if (buf)
-            mem.release(&buf);
+            pool.release(&buf);
 
         if (sData->response.payloadLen > 0 && sData->response.payloadRead >= sData->response.payloadLen && sData->response.tcpAvailable(client_type, client, async_tcp_config) == 0)
         {
             // Async payload and header data collision workaround from session reusage.
             if (!sData->response.flags.chunks && sData->response.payloadRead > sData->response.payloadLen)
             {
-                sData->response.val[res_hndlr_ns::header] = sData->response.val[res_hndlr_ns::payload].substring(sData->response.payloadRead - sData->response.payloadLen);
-                sData->response.val[res_hndlr_ns::payload].remove(0, sData->response.payloadLen);
+                sData->response.splitHeader();
                 sData->return_type = function_return_type_continue;
                 sData->state = async_state_read_response;
                 sData->response.flags.header_remaining = true;
@@ -1218,37 +1330,6 @@ private:
         return sData->error.code == 0;
     }
 
-    // non-block memory buffer for collecting the multiple of 4 data prepared for base64 decoding
-    uint8_t *asyncBase64Buffer(async_data_item_t *sData, Memory &mem, int &toRead, int &read)
-    {
-        uint8_t *buf = nullptr;
-
-        if (sData->request.base64)
-        {
-            if (sData->response.toFill && sData->response.toFillLen)
-            {
-                int currentRead = sData->response.tcpRead(client_type, client, async_tcp_config, sData->response.toFill + sData->response.toFillIndex, sData->response.toFillLen);
-                if (currentRead == sData->response.toFillLen)
-                {
-                    buf = reinterpret_cast<uint8_t *>(mem.alloc(sData->response.toFillIndex + sData->response.toFillLen));
-                    memcpy(buf, sData->response.toFill, sData->response.toFillIndex + sData->response.toFillLen);
-                    mem.release(&sData->response.toFill);
-                    read = sData->response.toFillLen + sData->response.toFillIndex;
-                    toRead = read;
-                    sData->response.toFillIndex = 0;
-                    sData->response.toFillLen = 0;
-                }
-                else
-                {
-                    sData->response.toFillIndex += currentRead;
-                    sData->response.toFillLen -= currentRead;
-                }
-            }
-        }
-
-        return buf;
-    }
-
     void clear(async_data_item_t *sData)
     {
         clear(sData->response.val[res_hndlr_ns::header]);
@@ -1284,11 +1365,26 @@ private:
         sData->aResult.lastError.clearError();
         lastErr.clearError();
 
-        if (client && !client->connected() && !sData->auth_used) // This info is already show in auth task
+        if (client && !client->connected() && !sData->auth_used && !tcp_connecting) // This info is already show in auth task
             sData->aResult.setDebug(FPSTR("Connecting to server..."));
 
         if (client && !client->connected() && client_type == async_request_handler_t::tcp_client_type_sync)
-            sData->return_type = client->connect(host, port) > 0 ? function_return_type_complete : function_return_type_failure;
+        {
+            // allow non-blocking connection (SSL handshake) for async task
+            if (sData->async && tcp_connect_start && tcp_connect_poll)
+            {
+                if (!tcp_connecting)
+                    sData->return_type = tcp_connect_start(host, port) > 0 ? function_return_type_continue : function_return_type_failure;
+                else
+                {
+                    int status = tcp_connect_poll();
+                    sData->return_type = status > 0 ? function_return_type_complete : (status < 0 ? function_return_type_failure : function_return_type_continue);
+                }
+                tcp_connecting = sData->return_type == function_return_type_continue;
+            }
+            else
+                sData->return_type = client->connect(host, port) > 0 ? function_return_type_complete : function_return_type_failure;
+        }
         else if (client_type == async_request_handler_t::tcp_client_type_async)
         {
 
@@ -1649,6 +1745,9 @@ private:
             slot = 0;
         else
         {
+            if (!admit(options))
+                return -2;
+
             int sse_index = -1, auth_index = -1;
             for (size_t i = 0; i < sVec.size(); i++)
             {
@@ -1667,7 +1766,7 @@ private:
                 slot = sse_index;
 
             // Multiple SSE modes
-            if ((sse_index > -1 && options.sse) || sVec.size() >= FIREBASE_ASYNC_QUEUE_LIMIT)
+            if (sse_index > -1 && options.sse)
                 slot = -2;
 
             if (slot >= (int)sVec.size())
@@ -1677,6 +1776,46 @@ private:
         return slot;
     }
 
+    // Check whether the new request fits the queue limit or the memory budget.
+    bool admit(slot_options_t &options)
+    {
+#if defined(FIREBASE_ASYNC_QUEUE_MEM_BUDGET)
+        size_t size = FIREBASE_SLOT_RESERVE_SIZE + options.payload_size;
+#if FIREBASE_ASYNC_QUEUE_WAIT_SEC > 0
+        // Run the queue to free its memory, this is not possible from the callback while processing.
+        if (!inProcess && !fitBudget(size))
+        {
+            Timer timer;
+            timer.feed(FIREBASE_ASYNC_QUEUE_WAIT_SEC);
+            while (!fitBudget(size) && !timer.ready())
+            {
+                process(true);
+                handleRemove();
+                yield();
+            }
+        }
+#endif
+        return fitBudget(size);
+#else
+        (void)options;
+        return sVec.size() < FIREBASE_ASYNC_QUEUE_LIMIT;
+#endif
+    }
+
+#if defined(FIREBASE_ASYNC_QUEUE_MEM_BUDGET)
+    // Get the memory in bytes that the queued slots hold.
+    size_t reservedSize()
+    {
+        size_t size = 0;
+        for (size_t i = 0; i < sVec.size(); i++)
+            size += FIREBASE_SLOT_RESERVE_SIZE + getData(i)->textSize();
+        return size;
+    }
+
+    // The request that is larger than the budget is admitted only when the queue is empty.
+    bool fitBudget(size_t size) { return sVec.size() == 0 || reservedSize() + size <= FIREBASE_ASYNC_QUEUE_MEM_BUDGET; }
+#endif
+
     void setContentType(async_data_item_t *sData, const String &type)
     {
         sData->request.addContentTypeHeader(type.c_str());
@@ -1847,6 +1986,12 @@ public:
             sData = nullptr;
         }
 
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+        for (size_t i = 0; i < spareVec.size(); i++)
+            delete reinterpret_cast<async_data_item_t *>(spareVec[i]);
+        spareVec.clear();
+#endif
+
         addRemoveClientVec(cvec_addr, false);
     }
 
@@ -1863,6 +2008,7 @@ public:
         {
             if (client)
                 client->stop();
+            tcp_connecting = false;
         }
         else
         {
@@ -1886,6 +2032,19 @@ public:
 
     void setSyncReadTimeout(uint32_t timeoutSec) { sync_read_timeout_sec = timeoutSec; }
 
+    uint32_t chunkPoolMisses() const { return pool.misses(); }
+
+    void addIdleTask(IdleTaskCallback cb, void *arg = nullptr) { idleQueue.add(cb, arg); }
+
+    void removeIdleTask(IdleTaskCallback cb, void *arg = nullptr) { idleQueue.remove(cb, arg); }
+
+    void setConnectionCallbacks(TCPConnectStart connectStart, TCPConnectPoll connectPoll)
+    {
+        tcp_connect_start = connectStart;
+        tcp_connect_poll = connectPoll;
+        tcp_connecting = false;
+    }
+
     async_data_item_t *createSlot(slot_options_t &options)
     {
         int slot_index = sMan(options);
@@ -1972,6 +2131,14 @@ public:
         }
     }
 
+    void setJSONWriter(async_data_item_t *sData, JSONWriterCallback cb)
+    {
+        // The content is written by the callback while sending, only its length is calculated here.
+        sData->request.writer_cb = cb;
+        sData->request.writer_len = JSONWriter::measure(cb);
+        setContentLength(sData, sData->request.writer_len);
+    }
+
     void setContentLength(async_data_item_t *sData, size_t len)
     {
         if (sData->request.method == async_request_handler_t::http_post || sData->request.method == async_request_handler_t::http_put || sData->request.method == async_request_handler_t::http_patch)
@@ -2015,6 +2182,8 @@ public:
                 return;
             }
 
+            FIREBASE_MEM_STATS_SCOPE(sData->sse ? mem_op_sse_event : (sData->request.method == async_request_handler_t::http_get ? mem_op_get : mem_op_set));
+
             // We have to re-start sse when the authenticate changed
             if (sData->sse && sData->auth_ts != auth_ts)
             {
@@ -2023,7 +2192,7 @@ public:
             }
 
             bool sending = false;
-            if (sData->state == async_state_undefined || sData->state == async_state_send_header || sData->state == async_state_send_payload)
+            if (sData->state == async_state_undefined || sData->state == async_state_connect || sData->state == async_state_send_header || sData->state == async_state_send_payload)
             {
                 sData->response.clear();
                 sData->request.feedTimer(!sData->async && sync_send_timeout_sec > 0 ? sync_send_timeout_sec : -1);
@@ -2121,6 +2290,8 @@ public:
             if (sData->to_remove)
                 removeSlot(slot);
         }
+        else // No slot pending, do the idle work.
+            idleQueue.run();
 
         inProcess = false;
     }
@@ -2136,6 +2307,13 @@ public:
 
     size_t slotCount() { return sVec.size(); }
 
+    bool requestInProgress()
+    {
+        // The first slot request (except for SSE) was already sent or is being sent.
+        async_data_item_t *sData = slotCount() ? getData(0) : nullptr;
+        return sData && !sData->sse && !sData->auth_used && sData->state != async_state_undefined;
+    }
+
     void removeSlot(uint8_t slot, bool sse = true)
     {
         async_data_item_t *sData = getData(slot);
@@ -2153,11 +2331,29 @@ public:
         setLastError(sData);
         // data available from sync and asyn request except for sse
         returnResult(sData, true);
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+        size_t text_size = sData->textSize();
+#endif
         reset(sData, sData->auth_used);
         if (!sData->auth_used)
-            delete sData;
+        {
+#if defined(FIREBASE_SLOT_ARENA_SIZE)
+            // Keep the slot and its buffers for the next request when its text fits the budget.
+            if (spareVec.size() < FIREBASE_SLOT_ARENA_COUNT && text_size <= FIREBASE_SLOT_ARENA_SIZE)
+            {
+                sData->recycle();
+                spareVec.push_back(sData->addr);
+            }
+            else
+#endif
+                delete sData;
+        }
         sData = nullptr;
         sVec.erase(sVec.begin() + slot);
+
+        // The chunk buffers are not kept while the client is idle.
+        if (sVec.size() == 0)
+            pool.shrink();
     }
 };
 
@@ -30,6 +30,7 @@
 #include "./core/Timer.h"
 #include "Client.h"
 #include "./core/AuthConfig.h"
+#include "./core/JSONWriter.h"
 
 #if defined(ENABLE_ASYNC_TCP_CLIENT)
 #include "./core/AsyncTCPConfig.h"
@@ -39,6 +40,20 @@
 
 #define FIREBASE_AUTH_PLACEHOLDER (const char *)FPSTR("<auth_token>")
 
+#if defined(FIREBASE_SLOT_ARENA_SIZE) && !defined(FIREBASE_SLOT_ARENA_COUNT)
+#define FIREBASE_SLOT_ARENA_COUNT 2
+#endif
+
+#if defined(FIREBASE_ASYNC_QUEUE_MEM_BUDGET)
+// The memory in bytes that is counted for each queued slot in addition to its header and payload.
+#if !defined(FIREBASE_SLOT_RESERVE_SIZE)
+#define FIREBASE_SLOT_RESERVE_SIZE 1024
+#endif
+#if !defined(FIREBASE_ASYNC_QUEUE_WAIT_SEC)
+#define FIREBASE_ASYNC_QUEUE_WAIT_SEC 0
+#endif
+#endif
+
 #if !defined(FIREBASE_ASYNC_QUEUE_LIMIT)
 #if defined(ESP8266)
 #define FIREBASE_ASYNC_QUEUE_LIMIT 10
@@ -92,24 +107,43 @@ public:
     uint16_t port = 443;
     uint8_t *data = nullptr;
     file_config_data file_data;
+    JSONWriterCallback writer_cb = NULL;
+    uint32_t writer_len = 0;
     bool base64 = false;
     bool ota = false;
     uint32_t payloadLen = 0;
     uint32_t dataLen = 0;
     uint32_t payloadIndex = 0;
     uint16_t dataIndex = 0;
-    int8_t b64Pad = 0;
     int16_t ota_error = 0;
     http_request_method method = http_undefined;
     Timer send_timer;
+    size_t buf_size = 0; // The largest text size that val held, the String keeps its capacity after clearing.
 
     async_request_handler_t()
     {
     }
 
+    // Get the largest text size that val held.
+    size_t bufSize()
+    {
+        size_t size = 0;
+        for (size_t i = 0; i < req_hndlr_ns::max_type; i++)
+            size += val[i].length();
+        if (size > buf_size)
+            buf_size = size;
+        return buf_size;
+    }
+
+    void clearPayload()
+    {
+        bufSize();
+        val[req_hndlr_ns::payload].remove(0, val[req_hndlr_ns::payload].length());
+    }
+
     void clear()
     {
-         
+        bufSize();
         for (size_t i = 0; i < req_hndlr_ns::max_type; i++)
             val[i].remove(0, val[i].length());
         port = 443;
@@ -117,13 +151,14 @@ public:
             delete data;
         data = nullptr;
         file_data.clear();
+        writer_cb = NULL;
+        writer_len = 0;
         base64 = false;
         ota = false;
         payloadLen = 0;
         dataLen = 0;
         payloadIndex = 0;
         dataIndex = 0;
-        b64Pad = 0;
         ota_error = 0;
         method = http_undefined;
     }
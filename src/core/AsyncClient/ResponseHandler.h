@@ -27,6 +27,7 @@
 #include <Arduino.h>
 #include <Client.h>
 #include "RequestHandler.h"
+#include "./core/Base64.h"
 
 #define FIREBASE_TCP_READ_TIMEOUT_SEC 30 // Do not change
 
@@ -90,40 +91,49 @@ public:
     size_t payloadLen = 0;
     size_t payloadRead = 0;
     auth_error_t error;
-    uint8_t *toFill = nullptr;
-    uint16_t toFillLen = 0;
-    uint16_t toFillIndex = 0;
+    // The Base64 download decoder that keeps the incomplete quantum between reads.
+    Base64Decoder b64;
     String val[res_hndlr_ns::max_type];
     chunk_info_t chunkInfo;
     Timer read_timer;
     bool auth_data_available = false;
+    size_t buf_size = 0; // The largest text size that val held, the String keeps its capacity after clearing.
 
     async_response_handler_t()
     {
     }
 
-    ~async_response_handler_t()
+    ~async_response_handler_t() {}
+
+    // Get the largest text size that val held.
+    size_t bufSize()
+    {
+        size_t size = 0;
+        for (size_t i = 0; i < res_hndlr_ns::max_type; i++)
+            size += val[i].length();
+        if (size > buf_size)
+            buf_size = size;
+        return buf_size;
+    }
+
+    // Move the data after the payload (the next response from the reused session) to the header.
+    void splitHeader()
     {
-        if (toFill)
-            free(toFill);
-        toFill = nullptr;
-        toFillLen = 0;
-        toFillIndex = 0;
+        bufSize();
+        val[res_hndlr_ns::header] = val[res_hndlr_ns::payload].substring(payloadRead - payloadLen);
+        val[res_hndlr_ns::payload].remove(0, payloadLen);
     }
 
     void clear()
     {
+        bufSize();
         httpCode = 0;
         flags.reset();
         payloadLen = 0;
         payloadRead = 0;
         error.resp_code = 0;
         error.string.remove(0, error.string.length());
-        if (toFill)
-            delete toFill;
-        toFill = nullptr;
-        toFillLen = 0;
-        toFillIndex = 0;
+        b64.reset();
         for (size_t i = 0; i < res_hndlr_ns::max_type; i++)
             val[i].remove(0, val[i].length());
         chunkInfo.chunkSize = 0;
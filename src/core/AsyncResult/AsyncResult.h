@@ -24,16 +24,40 @@
  */
 #ifndef ASYNC_RESULT_H
 #define ASYNC_RESULT_H
+#include <utility>
 #include "Value.h"
 #include "./core/Error.h"
 #include "./core/List.h"
 #include "./core/Timer.h"
 #include "./core/StringUtil.h"
+#include "./core/JSONTokenizer.h"
+#include "./core/JSONIndex.h"
 
 #define FIREBASE_CHUNK_SIZE 2048
 #define FIREBASE_BASE64_CHUNK_SIZE 1026
 #define FIREBASE_SSE_TIMEOUT 40 * 1000
 
+// The progress percent step that emits the upload and download progress event.
+#if !defined(FIREBASE_PROGRESS_PERCENT)
+#define FIREBASE_PROGRESS_PERCENT 2
+#endif
+
+// The bytes transferred since the last progress event that also emit the event, 0 for percent step only.
+#if !defined(FIREBASE_PROGRESS_BYTES)
+#define FIREBASE_PROGRESS_BYTES 0
+#endif
+
+// The minimum interval in ms between the progress events.
+#if !defined(FIREBASE_PROGRESS_INTERVAL_MS)
+#define FIREBASE_PROGRESS_INTERVAL_MS 0
+#endif
+
+// Emit the 100 percent progress event regardless of the interval, set to 0 to throttle it as other events.
+// When set to 0, the 100 percent event that comes within the interval is not emitted.
+#if !defined(FIREBASE_PROGRESS_FINAL)
+#define FIREBASE_PROGRESS_FINAL 1
+#endif
+
 using namespace firebase;
 
 namespace ares_ns
@@ -68,6 +92,54 @@ namespace firebase
         }
     };
 #if defined(ENABLE_DATABASE)
+    // The non-owning view of the part of the payload.
+    class PayloadView : public Printable
+    {
+    public:
+        PayloadView(const char *data = "", size_t len = 0, String *cache = nullptr) : p(data), n(len), cache(cache) {}
+        const char *data() const { return p; }
+        size_t length() const { return n; }
+
+        // Get the null-terminated string, the view is copied only when it does not end the payload.
+        const char *c_str() const
+        {
+            if (p[n] == 0 || !cache)
+                return p;
+            cache->remove(0, cache->length());
+            cache->concat(p, n);
+            return cache->c_str();
+        }
+
+        int indexOf(const char *s) const
+        {
+            size_t len = strlen(s);
+            for (size_t i = 0; len <= n && i <= n - len; i++)
+            {
+                if (memcmp(p + i, s, len) == 0)
+                    return i;
+            }
+            return -1;
+        }
+
+        bool equals(const char *s) const { return strlen(s) == n && memcmp(p, s, n) == 0; }
+        bool operator==(const char *s) const { return equals(s); }
+        bool operator!=(const char *s) const { return !equals(s); }
+
+        operator String() const
+        {
+            String s;
+            s.concat(p, n);
+            return s;
+        }
+
+        size_t printTo(Print &pr) const override { return pr.write(reinterpret_cast<const uint8_t *>(p), n); }
+
+    private:
+        const char *p = "";
+        size_t n = 0;
+        String *cache = nullptr;
+    };
+
     struct RealtimeDatabaseResult
     {
         friend class AsyncResult;
@@ -81,23 +153,58 @@ namespace firebase
         };
 
     public:
+        /**
+         * Get the value of the data.
+         * The value is converted once per payload or event, the following calls return the converted value.
+         */
+        template <typename T>
+        auto to() -> typename std::enable_if<ValueConverter::v_number<T>::value || std::is_same<T, bool>::value, T>::type
+        {
+            if (!value_parsed)
+            {
+                PayloadView v = data();
+                vcon.parse(v.data(), v.length());
+                value_parsed = true;
+            }
+            return vcon.value<T>();
+        }
+
         template <typename T>
-        T to() { return vcon.to<T>(data().c_str()); }
+        auto to() -> typename std::enable_if<ValueConverter::v_sring<T>::value, T>::type
+        {
+            if (!string_parsed)
+            {
+                PayloadView v = data();
+                vcon.setString(v.data(), v.length());
+                string_parsed = true;
+            }
+            return vcon.string();
+        }
+
         bool isStream() const { return sse; }
         String name() const { return node_name.c_str(); }
         String ETag() const { return etag.c_str(); }
-        String dataPath() const { return ref_payload ? ref_payload->substring(data_path_p1, data_path_p2).c_str() : ""; }
-        String event() { return ref_payload ? ref_payload->substring(event_p1, event_p2).c_str() : ""; }
-        String data()
+        PayloadView dataPath() const { return view(data_path_p1, data_path_p2, &path_cache); }
+        PayloadView event() const { return view(event_p1, event_p2, &event_cache); }
+        PayloadView data() const
         {
             if (data_p1 > 0)
-                return ref_payload->substring(data_p1, data_p2).c_str();
-            return ref_payload ? ref_payload->c_str() : "";
+                return view(data_p1, data_p2, &data_cache);
+            return ref_payload ? PayloadView(ref_payload->c_str(), ref_payload->length()) : PayloadView();
         }
 
         bool eventTimeout() { return sse && sse_timer.remaining() == 0; }
 
-        realtime_database_data_type type() { return vcon.getType(data().c_str()); }
+        realtime_database_data_type type()
+        {
+            if (!type_parsed)
+            {
+                PayloadView v = data();
+                data_type = vcon.getType(v.data(), v.length());
+                type_parsed = true;
+            }
+            return data_type;
+        }
 
         void clearSSE()
         {
@@ -109,67 +216,111 @@ namespace firebase
             data_p2 = 0;
             sse = false;
             event_resume_status = event_resume_status_undefined;
+            clearCache();
+        }
+        void clearCache()
+        {
+            type_parsed = false;
+            value_parsed = false;
+            string_parsed = false;
         }
         void parseNodeName()
         {
-            int p1 = 0, p2 = 0;
-            sut.parse(*ref_payload, "\"name\"", "}", p1, p2);
-            if (p1 > -1 && p2 > -1)
+            JSONTokenizer tk(ref_payload->c_str(), ref_payload->length());
+            json_token_t token;
+            while ((token = tk.next()) != json_token_none && token != json_token_error)
             {
-                node_name = ref_payload->substring(p1 + 1, p2 - 1);
+                if (token == json_token_value && tk.depth() == 1 && tk.keyIs("name"))
+                {
+                    tk.get(node_name);
+                    return;
+                }
             }
         }
         void parseSSE()
         {
             clearSSE();
-            int p1 = 0, p2 = 0;
-            sut.parse(*ref_payload, "event", "\n", p1, p2);
-            if (p1 > -1 && p2 > -1)
-            {
-                event_p1 = p1;
-                event_p2 = p2;
-                p1 = p2;
-                setEventResumeStatus(event_resume_status_undefined);
-                sse_timer.feed(String(event()).indexOf("cancel") > -1 || String(event()).indexOf("auth_revoked") > -1 ? 0 : FIREBASE_SSE_TIMEOUT);
-                sse = true;
-            }
+            const char *buf = ref_payload->c_str();
+            int len = ref_payload->length(), data_start = -1, data_end = -1;
 
-            sut.parse(*ref_payload, "data", "\n", p1, p2);
-            if (p1 > -1 && p2 > -1)
+            // The event stream lines e.g. "event: put" and "data: {"path":"/","data":{...}}".
+            for (int i = 0, end = 0; i < len; i = end + 1)
             {
-                int p3 = p1, p4 = p2;
-                if (ref_payload->substring(p1, p2) == "null")
+                end = i;
+                while (end < len && buf[end] != '\n')
+                    end++;
+
+                int p = -1;
+                if (strncmp(buf + i, "event:", 6) == 0)
+                    p = i + 6;
+                else if (strncmp(buf + i, "data:", 5) == 0)
+                    p = i + 5;
+                else
+                    continue;
+
+                while (p < end && buf[p] == ' ')
+                    p++;
+
+                if (buf[i] == 'e')
                 {
-                    data_p1 = p1;
-                    data_p2 = p2;
-                    return;
+                    event_p1 = p;
+                    event_p2 = end;
+                    setEventResumeStatus(event_resume_status_undefined);
+                    sse_timer.feed(event().indexOf("cancel") > -1 || event().indexOf("auth_revoked") > -1 ? 0 : FIREBASE_SSE_TIMEOUT);
+                    sse = true;
                 }
-
-                sut.parse(*ref_payload, "\"path\"", ",", p1, p2);
-                if (p1 > -1 && p2 > -1)
+                else if (data_start == -1)
                 {
-                    data_path_p1 = p1 + 1;
-                    data_path_p2 = p2 - 1;
-                    p1 = p2;
+                    data_start = p;
+                    data_end = end;
                 }
+            }
+
+            if (data_start == -1)
+                return;
 
-                sut.parse(*ref_payload, "\"data\"", "\n", p1, p2);
-                if (p1 > -1 && p2 > -1)
+            if (data_end - data_start == 4 && strncmp(buf + data_start, "null", 4) == 0)
+            {
+                data_p1 = data_start;
+                data_p2 = data_end;
+                return;
+            }
+
+            // The path and data of the put and patch event data object.
+            JSONTokenizer tk(buf + data_start, data_end - data_start);
+            json_token_t token;
+            int value_start = -1;
+            while ((token = tk.next()) != json_token_none && token != json_token_error)
+            {
+                if (token == json_token_value && tk.depth() == 1 && tk.keyIs("path"))
                 {
-                    if ((*ref_payload)[p2 - 1] == '}')
-                        p2--;
-                    data_p1 = p1;
-                    data_p2 = p2;
+                    data_path_p1 = data_start + tk.position();
+                    data_path_p2 = data_path_p1 + tk.length();
                 }
-
-                if (data_p1 == 0)
+                else if (token == json_token_value && tk.depth() == 1 && tk.keyIs("data"))
                 {
-                    data_p1 = p3;
-                    data_p2 = p4;
+                    // The raw value, the string value with its quotes.
+                    data_p1 = data_start + tk.position() - (tk.isString() ? 1 : 0);
+                    data_p2 = data_start + tk.position() + tk.length() + (tk.isString() ? 1 : 0);
                 }
+                else if ((token == json_token_begin_object || token == json_token_begin_array) && tk.depth() == 2 && tk.keyIs("data"))
+                    value_start = data_start + tk.position();
+                else if ((token == json_token_end_object || token == json_token_end_array) && tk.depth() == 1 && value_start > -1)
+                {
+                    data_p1 = value_start;
+                    data_p2 = data_start + tk.position() + 1;
+                    value_start = -1;
+                }
+            }
+
+            if (data_p1 == 0)
+            {
+                data_p1 = data_start;
+                data_p2 = data_end;
             }
         }
         void setEventResumeStatus(event_resume_status_t status) { event_resume_status = status; }
+        void setNodeName(const String &name) { node_name = name; }
 
         event_resume_status_t eventResumeStatus() const { return event_resume_status; }
 
@@ -178,12 +329,17 @@ namespace firebase
 
     private:
         ValueConverter vcon;
-        StringUtil sut;
         Timer sse_timer;
         bool sse = false;
         event_resume_status_t event_resume_status = event_resume_status_undefined;
         String node_name, etag;
+        mutable String path_cache, event_cache, data_cache;
         uint16_t data_path_p1 = 0, data_path_p2 = 0, event_p1 = 0, event_p2 = 0, data_p1 = 0, data_p2 = 0;
+        realtime_database_data_type data_type = realtime_database_data_type_undefined;
+        bool type_parsed = false, value_parsed = false, string_parsed = false;
+
+        PayloadView view(uint16_t p1, uint16_t p2, String *cache) const { return ref_payload && p2 > p1 ? PayloadView(ref_payload->c_str() + p1, p2 - p1, cache) : PayloadView(); }
+
     };
 #endif
 }
@@ -201,12 +357,54 @@ class AsyncResult
     friend class FirestoreDocuments;
     friend class async_data_item_t;
 
+    struct progress_state_t
+    {
+        size_t last_bytes = 0;
+        uint32_t last_ms = 0;
+
+        // Check whether the progress event is due by the percent step, the transferred bytes and the interval.
+        bool due(size_t done, size_t total, int &progress)
+        {
+            if (done == 0 || total == 0)
+                return false;
+
+            int percent = done >= total ? 100 : (int)((uint64_t)done * 100 / total);
+            bool step = progress == -1 || percent >= progress + FIREBASE_PROGRESS_PERCENT;
+#if FIREBASE_PROGRESS_BYTES > 0
+            if (done - last_bytes >= FIREBASE_PROGRESS_BYTES)
+                step = true;
+#endif
+            bool final = percent == 100 && progress != 100;
+            if (!final && !step)
+                return false;
+
+#if FIREBASE_PROGRESS_INTERVAL_MS > 0
+            // The 100 percent event within the interval is dropped when FIREBASE_PROGRESS_FINAL is 0.
+            uint32_t ms = millis();
+            if ((!final || !FIREBASE_PROGRESS_FINAL) && progress != -1 && ms - last_ms < FIREBASE_PROGRESS_INTERVAL_MS)
+                return false;
+            last_ms = ms;
+#endif
+
+            progress = percent;
+            last_bytes = done;
+            return true;
+        }
+
+        void reset()
+        {
+            last_bytes = 0;
+            last_ms = 0;
+        }
+    };
+
     struct download_data_t
     {
     public:
         size_t total = 0, downloaded = 0;
         bool progress_available = false, ota = false;
         int progress = -1;
+        progress_state_t state;
         void reset()
         {
             total = 0;
@@ -214,6 +412,7 @@ class AsyncResult
             progress_available = false;
             progress = -1;
             ota = false;
+            state.reset();
         }
     };
 
@@ -223,6 +422,7 @@ class AsyncResult
         size_t total = 0, uploaded = 0;
         bool progress_available = false;
         int progress = -1;
+        progress_state_t state;
         String downloadUrl;
         void reset()
         {
@@ -230,6 +430,7 @@ class AsyncResult
             uploaded = 0;
             progress_available = false;
             progress = -1;
+            state.reset();
             downloadUrl.remove(0, downloadUrl.length());
         }
     };
@@ -242,6 +443,8 @@ private:
     uint32_t debug_ms = 0, last_debug_ms = 0;
     download_data_t download_data;
     upload_data_t upload_data;
+    JSONIndex json_index;
+    ValueConverter vcon;
 #if defined(ENABLE_DATABASE)
     RealtimeDatabaseResult rtdbResult;
 #endif
@@ -252,6 +455,10 @@ private:
         {
             data_available = true;
             val[ares_ns::data_payload] = data;
+            json_index.clear();
+#if defined(ENABLE_DATABASE)
+            rtdbResult.clearCache();
+#endif
         }
 #if defined(ENABLE_DATABASE)
         rtdbResult.ref_payload = &val[ares_ns::data_payload];
@@ -261,36 +468,67 @@ private:
     void setETag(const String &etag) { val[ares_ns::res_etag] = etag; }
     void setPath(const String &path) { val[ares_ns::data_path] = path; }
 
-    bool setDownloadProgress()
+    // Copy the download and upload progress only.
+    void setProgress(const AsyncResult &src)
+    {
+        download_data = src.download_data;
+        upload_data = src.upload_data;
+    }
+
+    // Hand over the slot result, the payload is delivered only when setData is true.
+    // When swap is true, the payload buffers are swapped instead of copied and the slot gets this payload buffer back cleared.
+    void setResult(AsyncResult &src, bool setData, bool swap)
     {
-        download_data.progress_available = false;
-        if (download_data.downloaded > 0)
+        for (size_t i = 0; i < ares_ns::max_type; i++)
+        {
+            if (i != ares_ns::data_payload)
+                val[i] = src.val[i];
+        }
+        debug_info_available = src.debug_info_available;
+        debug_ms = src.debug_ms;
+        setProgress(src);
+        data_available = src.data_available;
+        error_available = src.error_available;
+        app_event = src.app_event;
+        lastError = src.lastError;
+
+        if (setData)
         {
-            int progress = (float)download_data.downloaded / download_data.total * 100;
-            if (download_data.progress != progress && (progress == 0 || progress == 100 || download_data.progress + 2 <= progress))
+            if (swap)
             {
-                download_data.progress_available = true;
-                download_data.progress = progress;
-                return true;
+                std::swap(val[ares_ns::data_payload], src.val[ares_ns::data_payload]);
+                src.val[ares_ns::data_payload].remove(0, src.val[ares_ns::data_payload].length());
+                src.data_available = false;
+                src.json_index.clear();
             }
+            else
+                val[ares_ns::data_payload] = src.val[ares_ns::data_payload];
+
+            if (val[ares_ns::data_payload].length())
+                data_available = true;
+            json_index.clear();
+#if defined(ENABLE_DATABASE)
+            rtdbResult = src.rtdbResult;
+            rtdbResult.clearCache();
+            if (swap)
+                src.rtdbResult.clearCache();
+#endif
         }
-        return false;
+#if defined(ENABLE_DATABASE)
+        rtdbResult.ref_payload = &val[ares_ns::data_payload];
+#endif
+    }
+
+    bool setDownloadProgress()
+    {
+        download_data.progress_available = download_data.state.due(download_data.downloaded, download_data.total, download_data.progress);
+        return download_data.progress_available;
     }
 
     bool setUploadProgress()
     {
-        upload_data.progress_available = false;
-        if (upload_data.uploaded > 0)
-        {
-            int progress = (float)upload_data.uploaded / upload_data.total * 100;
-            if (upload_data.progress != progress && (progress == 0 || progress == 100 || upload_data.progress + 2 <= progress))
-            {
-                upload_data.progress_available = true;
-                upload_data.progress = progress;
-                return true;
-            }
-        }
-        return false;
+        upload_data.progress_available = upload_data.state.due(upload_data.uploaded, upload_data.total, upload_data.progress);
+        return upload_data.progress_available;
     }
 
 public:
@@ -351,9 +589,11 @@ public:
         for (size_t i = 0; i < ares_ns::max_type; i++)
             val[i].remove(0, val[i].length());
         debug_info_available = false;
+        json_index.clear();
         lastError.setLastError(0, "");
         app_event.setEvent(0, "");
         data_available = false;
+        error_available = false;
         download_data.reset();
         upload_data.reset();
 #if defined(ENABLE_DATABASE)
@@ -368,6 +608,49 @@ public:
             return rtdbResult;
         return o;
     }
+
+    /**
+     * Get the value of the path in the JSON payload.
+     * The payload is indexed once when the path was first queried, the following queries use the index.
+     * @param path The path of the value e.g. "a/b/c", the array element is selected with its index e.g. "items/0/name".
+     * @return String The value, the string value is unquoted and unescaped, the object and array are in JSON.
+     * The empty string is returned when the path was not found.
+     */
+    template <typename T = String>
+    auto get(const String &path) -> typename std::enable_if<!std::is_arithmetic<T>::value, T>::type
+    {
+        String value;
+        size_t pos = 0, len = 0;
+        bool isString = false;
+        if (json_index.find(val[ares_ns::data_payload], path, pos, len, isString))
+        {
+            value.concat(val[ares_ns::data_payload].c_str() + pos, len);
+            if (isString)
+                JSONTokenizer::unescape(value);
+        }
+        return value;
+    }
+
+    /**
+     * Get the number or boolean value of the path in the JSON payload.
+     * The string value that contains the number e.g. the Firestore integerValue is also converted.
+     * @param path The path of the value e.g. "fields/count/integerValue".
+     * @return T The value, zero or false when the path was not found.
+     */
+    template <typename T>
+    auto get(const String &path) -> typename std::enable_if<std::is_arithmetic<T>::value, T>::type
+    {
+        char buf[32];
+        size_t pos = 0, len = 0;
+        bool isString = false;
+        if (!json_index.find(val[ares_ns::data_payload], path, pos, len, isString))
+            return 0;
+        len = len < sizeof(buf) - 1 ? len : sizeof(buf) - 1;
+        memcpy(buf, val[ares_ns::data_payload].c_str() + pos, len);
+        buf[len] = 0;
+        return vcon.to<T>(buf);
+    }
+
     int available()
     {
         bool ret = data_available;
@@ -26,6 +26,7 @@
 #define VALUE_CONVERTER_H
 #include <Arduino.h>
 #include <string>
+#include "./core/NumberFormat.h"
 
 enum realtime_database_data_type
 {
@@ -65,11 +66,25 @@ private:
 public:
     number_t() {}
     template <typename T1 = int, typename T = int>
-    number_t(T1 v, T d) { buf = String(v, d); }
+    number_t(T1 v, T d) { set(v, d); }
     template <typename T = int>
-    number_t(T o) { buf = String(o); }
+    number_t(T o) { set(o); }
     const char *c_str() const { return buf.c_str(); }
     size_t printTo(Print &p) const { return p.print(buf.c_str()); }
+
+private:
+    template <typename T1, typename T>
+    auto set(T1 v, T d) -> typename std::enable_if<std::is_floating_point<T1>::value>::type { NumberFormat::toString(buf, v, d); }
+
+    // The integer with the base e.g. number_t(255, HEX).
+    template <typename T1, typename T>
+    auto set(T1 v, T d) -> typename std::enable_if<!std::is_floating_point<T1>::value>::type { buf = String(v, d); }
+
+    template <typename T>
+    auto set(T o) -> typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>::type { NumberFormat::toString(buf, o); }
+
+    template <typename T>
+    auto set(T o) -> typename std::enable_if<!std::is_arithmetic<T>::value || std::is_same<T, bool>::value>::type { buf = String(o); }
 };
 
 struct string_t : public Printable
@@ -152,7 +167,7 @@ public:
     object_t(const String &o) { buf = o; }
     const char *c_str() const { return buf.c_str(); }
     template <typename T = const char *>
-    object_t(T o) { buf = String(o); }
+    object_t(T o) { set(o); }
     object_t(boolean_t o) { buf = o.c_str(); }
     object_t(number_t o) { buf = o.c_str(); }
     object_t(string_t o) { buf = o.c_str(); }
@@ -181,6 +196,12 @@ private:
 
     size_t length() const { return buf.length(); }
     object_t substring(unsigned int beginIndex, unsigned int endIndex) const { return buf.substring(beginIndex, endIndex); }
+
+    template <typename T>
+    auto set(T o) -> typename std::enable_if<std::is_arithmetic<T>::value>::type { NumberFormat::toString(buf, o); }
+
+    template <typename T>
+    auto set(T o) -> typename std::enable_if<!std::is_arithmetic<T>::value>::type { buf = String(o); }
 };
 
 class ValueConverter
@@ -209,8 +230,14 @@ public:
         buf = value.c_str();
     }
 
+    template <typename T = int>
+    auto getVal(String &buf, T value) -> typename std::enable_if<v_number<T>::value, void>::type
+    {
+        NumberFormat::toString(buf, value);
+    }
+
     template <typename T = const char *>
-    auto getVal(String &buf, T value) -> typename std::enable_if<(v_number<T>::value || v_sring<T>::value || std::is_same<T, bool>::value) && !std::is_same<T, object_t>::value && !std::is_same<T, string_t>::value && !std::is_same<T, boolean_t>::value && !std::is_same<T, number_t>::value, void>::type
+    auto getVal(String &buf, T value) -> typename std::enable_if<(v_sring<T>::value || std::is_same<T, bool>::value) && !std::is_same<T, object_t>::value && !std::is_same<T, string_t>::value && !std::is_same<T, boolean_t>::value && !std::is_same<T, number_t>::value, void>::type
     {
         buf.remove(0, buf.length());
         if (std::is_same<T, bool>::value)
@@ -230,19 +257,43 @@ public:
     template <typename T>
     auto to(const char *payload) -> typename std::enable_if<v_number<T>::value || std::is_same<T, bool>::value, T>::type
     {
-        if (!useLength && strlen(payload) > 0)
+        parse(payload, strlen(payload));
+        return value<T>();
+    }
+
+    template <typename T>
+    auto to(const char *payload) -> typename std::enable_if<v_sring<T>::value, T>::type
+    {
+        setString(payload, strlen(payload));
+        return buf.c_str();
+    }
+
+    // Parse the number or boolean value of the payload, the value is kept until the next parse.
+    void parse(const char *payload, size_t len)
+    {
+        if (!useLength && len > 0)
         {
-            if (getType(payload) == realtime_database_data_type_boolean)
-                setBool(strcmp(payload, "true") == 0);
+            if (getType(payload, len) == realtime_database_data_type_boolean)
+                setBool(len == 4 && strncmp(payload, "true", 4) == 0);
             else
             {
-                setInt(payload);
-                setFloat(payload);
+                // The numeric value is short, the non null-terminated payload is copied to the stack.
+                char num[32];
+                len = len < sizeof(num) - 1 ? len : sizeof(num) - 1;
+                memcpy(num, payload, len);
+                num[len] = 0;
+                setInt(num);
+                setFloat(num);
             }
         }
         else
-            setBool(strlen(payload));
+            setBool(len);
+    }
 
+    // Get the value of the last parse.
+    template <typename T>
+    auto value() -> typename std::enable_if<v_number<T>::value || std::is_same<T, bool>::value, T>::type
+    {
         if (std::is_same<T, int>::value)
             return iVal.int32;
         else if (std::is_same<T, bool>::value)
@@ -271,25 +322,26 @@ public:
             return 0;
     }
 
-    template <typename T>
-    auto to(const char *payload) -> typename std::enable_if<v_sring<T>::value, T>::type
+    // Set the string value of the payload without its quotes, the value is kept until the next set.
+    void setString(const char *payload, size_t len)
     {
-        if (payload && payload[0] == '"' && payload[strlen(payload) - 1] == '"')
-        {
-            buf = payload + 1;
-            buf[buf.length() - 1] = 0;
-        }
-        else
-            buf = payload;
-
-        return buf.c_str();
+        buf.remove(0, buf.length());
+        if (len > 1 && payload[0] == '"' && payload[len - 1] == '"')
+            buf.concat(payload + 1, len - 2);
+        else if (len)
+            buf.concat(payload, len);
     }
 
-    realtime_database_data_type getType(const char *payload)
+    // Get the value of the last set.
+    const char *string() const { return buf.c_str(); }
+
+    realtime_database_data_type getType(const char *payload) { return getType(payload, strlen(payload)); }
+
+    realtime_database_data_type getType(const char *payload, size_t len)
     {
-        if (strlen(payload) > 0)
+        if (len > 0)
         {
-            size_t p1 = 0, p2 = strlen(payload) - 1;
+            size_t p1 = 0, p2 = len - 1;
 
             if (payload[p1] == '"')
                 return realtime_database_data_type_string;
@@ -307,7 +359,7 @@ public:
                 // response here should be numberic value
                 double d = atof(payload);
                 // find the dot and check its length to determine the type
-                if (String(payload).indexOf('.') != -1)
+                if (memchr(payload, '.', len))
                     return p2 <= 7 ? realtime_database_data_type_float : realtime_database_data_type_double;
                 else
                     // no dot, determine the type from its value
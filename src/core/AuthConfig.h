@@ -1288,11 +1288,19 @@ namespace firebase
         app_token_t() {}
     };
 
+#if defined(ENABLE_JWT)
+    class JWTClass;
+#endif
+
     struct auth_data_t
     {
         user_auth_data user_auth;
         app_token_t app_token;
         AsyncResultCallback cb;
+#if defined(ENABLE_JWT)
+        // The JWT signer of the app.
+        JWTClass *jwt = nullptr;
+#endif
     };
 
 };
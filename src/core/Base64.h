@@ -35,8 +35,301 @@
 #include <vector>
 #endif
 
+// The vectorized Base64 decoding on host targets.
+#if !defined(FIREBASE_DISABLE_SIMD)
+#if defined(__SSE2__)
+#define FIREBASE_BASE64_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define FIREBASE_BASE64_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 static const char firebase_boundary_table[] PROGMEM = "=_abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 static const unsigned char firebase_base64_table[65] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const unsigned char firebase_base64url_table[65] PROGMEM = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// The sextet of Base64 character, 0x80 for the character to skip and 0xc0 for the padding.
+static const unsigned char firebase_base64_dec_table[256] PROGMEM = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x80, 0x80, 0x80, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0xc0, 0x80, 0x80,
+    0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
+
+/**
+ * The streaming Base64 decoder.
+ *
+ * The source can be fed in chunks of any size, the incomplete quantum is kept for the next chunk.
+ * The characters that are not in Base64 alphabet e.g. the quotes and line breaks are skipped.
+ * The decoding stops at the padding.
+ */
+class Base64Decoder
+{
+public:
+    Base64Decoder() {}
+
+    void reset()
+    {
+        acc = 0;
+        count = 0;
+        padLen = 0;
+        end = false;
+    }
+
+    /**
+     * Decode the chunk.
+     * @param src The Base64 chunk.
+     * @param len The length of chunk.
+     * @param out The output buffer of at least (len + 3) / 4 * 3 bytes.
+     * @return size_t The number of bytes written.
+     */
+    size_t decode(const char *src, size_t len, uint8_t *out)
+    {
+        uint8_t *p = out;
+        size_t i = 0;
+        while (i < len && !end)
+        {
+            // The complete quanta are decoded without carrying the bits.
+            if (count == 0)
+            {
+#if defined(FIREBASE_BASE64_SSE2) || defined(FIREBASE_BASE64_NEON)
+                while (i + 16 <= len && decode16(src + i, p))
+                {
+                    i += 16;
+                    p += 12;
+                }
+#endif
+                while (i + 4 <= len)
+                {
+                    uint32_t a = sextet(src[i]), b = sextet(src[i + 1]), c = sextet(src[i + 2]), d = sextet(src[i + 3]);
+                    if ((a | b | c | d) & 0x80)
+                        break;
+                    put(p, a << 18 | b << 12 | c << 6 | d);
+                    i += 4;
+                }
+
+                if (i == len)
+                    break;
+            }
+
+            uint8_t v = sextet(src[i++]);
+            if (v == 0xc0)
+            {
+                // The padding, the remaining bits are written.
+                if (count == 2)
+                    *p++ = acc >> 4;
+                else if (count == 3)
+                {
+                    *p++ = acc >> 10;
+                    *p++ = acc >> 2;
+                }
+                padLen = count > 1 ? 4 - count : 0;
+                end = true;
+            }
+            else if (v < 0x80)
+            {
+                acc = acc << 6 | v;
+                if (++count == 4)
+                {
+                    put(p, acc);
+                    acc = 0;
+                    count = 0;
+                }
+            }
+        }
+        return p - out;
+    }
+
+    /**
+     * Write the remaining bits of the unpadded source.
+     * @param out The output buffer of at least 2 bytes.
+     * @return size_t The number of bytes written.
+     */
+    size_t finish(uint8_t *out)
+    {
+        size_t n = 0;
+        if (!end && count > 1)
+        {
+            if (count == 2)
+                out[n++] = acc >> 4;
+            else
+            {
+                out[n++] = acc >> 10;
+                out[n++] = acc >> 2;
+            }
+            padLen = 4 - count;
+        }
+        acc = 0;
+        count = 0;
+        end = true;
+        return n;
+    }
+
+    // Get the number of padding characters of the decoded source.
+    uint8_t pad() const { return padLen; }
+
+private:
+    uint32_t acc = 0;
+    uint8_t count = 0, padLen = 0;
+    bool end = false;
+
+    static uint8_t sextet(char c) { return pgm_read_byte(firebase_base64_dec_table + static_cast<uint8_t>(c)); }
+
+    static void put(uint8_t *&p, uint32_t v)
+    {
+        p[0] = v >> 16;
+        p[1] = v >> 8;
+        p[2] = v;
+        p += 3;
+    }
+
+#if defined(FIREBASE_BASE64_SSE2) || defined(FIREBASE_BASE64_NEON)
+    // Decode 16 characters to 12 bytes, returns false when any character is not in the alphabet.
+    static bool decode16(const char *src, uint8_t *out)
+    {
+        uint32_t w[4];
+#if defined(FIREBASE_BASE64_SSE2)
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+        const __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), v));
+        const __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), v));
+        const __m128i plus = _mm_cmpeq_epi8(v, _mm_set1_epi8('+')), slash = _mm_cmpeq_epi8(v, _mm_set1_epi8('/'));
+        if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, plus)), slash)) != 0xffff)
+            return false;
+
+        // The offset of each range to its sextet value.
+        __m128i ofs = _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+        ofs = _mm_or_si128(ofs, _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')), _mm_or_si128(_mm_and_si128(plus, _mm_set1_epi8(62 - '+')), _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+        v = _mm_add_epi8(v, ofs);
+
+        // Merge the sextet pairs into 12 bits, then the 12-bit pairs into 24 bits.
+        v = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00ff)), 6), _mm_srli_epi16(v, 8));
+        v = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0xffff)), 12), _mm_srli_epi32(v, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(w), v);
+#else
+        uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(src));
+        const uint8x16_t upper = vandq_u8(vcgeq_u8(v, vdupq_n_u8('A')), vcleq_u8(v, vdupq_n_u8('Z')));
+        const uint8x16_t lower = vandq_u8(vcgeq_u8(v, vdupq_n_u8('a')), vcleq_u8(v, vdupq_n_u8('z')));
+        const uint8x16_t digit = vandq_u8(vcgeq_u8(v, vdupq_n_u8('0')), vcleq_u8(v, vdupq_n_u8('9')));
+        const uint8x16_t plus = vceqq_u8(v, vdupq_n_u8('+')), slash = vceqq_u8(v, vdupq_n_u8('/'));
+        if (vminvq_u8(vorrq_u8(vorrq_u8(vorrq_u8(upper, lower), vorrq_u8(digit, plus)), slash)) == 0)
+            return false;
+
+        // The offset of each range to its sextet value.
+        uint8x16_t ofs = vorrq_u8(vandq_u8(upper, vdupq_n_u8(static_cast<uint8_t>(-'A'))), vandq_u8(lower, vdupq_n_u8(static_cast<uint8_t>(26 - 'a'))));
+        ofs = vorrq_u8(ofs, vorrq_u8(vandq_u8(digit, vdupq_n_u8(static_cast<uint8_t>(52 - '0'))), vorrq_u8(vandq_u8(plus, vdupq_n_u8(62 - '+')), vandq_u8(slash, vdupq_n_u8(63 - '/')))));
+        v = vaddq_u8(v, ofs);
+
+        // Merge the sextet pairs into 12 bits, then the 12-bit pairs into 24 bits.
+        uint16x8_t h = vreinterpretq_u16_u8(v);
+        h = vorrq_u16(vshlq_n_u16(vandq_u16(h, vdupq_n_u16(0x00ff)), 6), vshrq_n_u16(h, 8));
+        uint32x4_t q = vreinterpretq_u32_u16(h);
+        q = vorrq_u32(vshlq_n_u32(vandq_u32(q, vdupq_n_u32(0xffff)), 12), vshrq_n_u32(q, 16));
+        vst1q_u32(w, q);
+#endif
+        for (int k = 0; k < 4; k++)
+            put(out, w[k]);
+        return true;
+    }
+#endif
+};
+
+/**
+ * The streaming Base64 encoder.
+ *
+ * The source can be fed in chunks of any size, the incomplete 3-byte group is kept for the next chunk.
+ */
+class Base64Encoder
+{
+public:
+    /**
+     * @param url Set to true for the URL and filename safe alphabet without padding.
+     */
+    Base64Encoder(bool url = false) : url(url) {}
+
+    /**
+     * Encode the chunk.
+     * @param src The data chunk.
+     * @param len The length of chunk.
+     * @param out The output buffer of at least (len + 2) / 3 * 4 bytes.
+     * @return size_t The number of characters written.
+     */
+    size_t encode(const uint8_t *src, size_t len, char *out)
+    {
+        char *p = out;
+        while (count > 0 && count < 3 && len > 0)
+        {
+            rem[count++] = *src++;
+            len--;
+        }
+
+        if (count == 3)
+        {
+            put(p, rem[0] << 16 | rem[1] << 8 | rem[2]);
+            count = 0;
+        }
+
+        for (; len >= 3; src += 3, len -= 3)
+            put(p, src[0] << 16 | src[1] << 8 | src[2]);
+
+        while (len-- > 0)
+            rem[count++] = *src++;
+
+        return p - out;
+    }
+
+    /**
+     * Write the remaining bytes with padding.
+     * @param out The output buffer of at least 4 bytes.
+     * @return size_t The number of characters written.
+     */
+    size_t finish(char *out)
+    {
+        size_t n = 0;
+        if (count > 0)
+        {
+            uint32_t v = rem[0] << 16 | (count > 1 ? rem[1] << 8 : 0);
+            out[n++] = chr(v >> 18);
+            out[n++] = chr(v >> 12);
+            if (count > 1)
+                out[n++] = chr(v >> 6);
+            while (!url && n < 4)
+                out[n++] = '=';
+        }
+        count = 0;
+        return n;
+    }
+
+private:
+    uint8_t rem[3];
+    uint8_t count = 0;
+    bool url = false;
+
+    char chr(uint32_t v) const { return pgm_read_byte((url ? firebase_base64url_table : firebase_base64_table) + (v & 0x3f)); }
+
+    void put(char *&p, uint32_t v)
+    {
+        p[0] = chr(v >> 18);
+        p[1] = chr(v >> 12);
+        p[2] = chr(v >> 6);
+        p[3] = chr(v);
+        p += 4;
+    }
+};
 
 template <typename T>
 struct firebase_base64_io_t
@@ -94,19 +387,6 @@ public:
         return (3 * (len / 4)) - pad;
     }
 
-    unsigned char *creatBase64EncBuffer(Memory &mem, bool isURL)
-    {
-
-        unsigned char *base64EncBuf = reinterpret_cast<unsigned char *>(mem.alloc(65));
-        strcpy_P((char *)base64EncBuf, (char *)firebase_base64_table);
-        if (isURL)
-        {
-            base64EncBuf[62] = '-';
-            base64EncBuf[63] = '_';
-        }
-        return base64EncBuf;
-    }
-
     bool updateWrite(uint8_t *data, size_t len)
     {
 #if defined(OTA_UPDATE_ENABLED) && (defined(ENABLE_DATABASE) || defined(ENABLE_STORAGE) || defined(ENABLE_CLOUD_STORAGE))
@@ -117,17 +397,6 @@ public:
         return false;
     }
 
-    unsigned char *creatBase64DecBuffer(Memory &mem)
-    {
-
-        unsigned char *base64DecBuf = reinterpret_cast<unsigned char *>(mem.alloc(256, false));
-        memset(base64DecBuf, 0x80, 256);
-        for (size_t i = 0; i < sizeof(firebase_base64_table) - 1; i++)
-            base64DecBuf[firebase_base64_table[i]] = (unsigned char)i;
-        base64DecBuf['='] = 0;
-        return base64DecBuf;
-    }
-
     template <typename T = uint8_t>
     bool writeOutput(firebase_base64_io_t<T> &out)
     {
@@ -153,238 +422,84 @@ public:
         return false;
     }
 
-    template <typename T = uint8_t>
-    bool setOutput(uint8_t val, firebase_base64_io_t<T> &out, T **pos)
-    {
-        if (out.outT)
-        {
-#if defined(ENABLE_FS)
-            if (out.ota || out.outC || out.file || out.outB)
-#else
-            if (out.ota || out.outC || out.outB)
-#endif
-            {
-                out.outT[out.bufWrite++] = val;
-                if (out.bufWrite == (int)out.bufLen && !writeOutput(out))
-                    return false;
-            }
-            else
-                *(*pos)++ = (T)(val);
-        }
-        else if (out.outL)
-            out.outL->push_back(val);
-
-        return true;
-    }
-
-    template <typename T>
-    bool decode(Memory &mem, unsigned char *base64DecBuf, const char *src, size_t len, firebase_base64_io_t<T> &out)
-    {
-        // the maximum chunk size that writes to output is limited by out.bufLen, the minimum is depending on the source length
-        bool ret = false;
-        unsigned char *block = reinterpret_cast<unsigned char *>(mem.alloc(4, false));
-        unsigned char temp;
-        size_t i, count;
-        int pad = 0;
-        size_t extra_pad;
-        T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
-        if (len == 0)
-            len = strlen(src);
-
-        count = 0;
-
-        for (i = 0; i < len; i++)
-        {
-            if ((uint8_t)base64DecBuf[(uint8_t)src[i]] != 0x80)
-                count++;
-        }
-
-        if (count == 0)
-            goto skip;
-
-        extra_pad = (4 - count % 4) % 4;
-        count = 0;
-        for (i = 0; i < len + extra_pad; i++)
-        {
-            unsigned char val;
-
-            if (i >= len)
-                val = '=';
-            else
-                val = src[i];
-
-            temp = base64DecBuf[val];
-
-            if (temp == 0x80)
-                continue;
-
-            if (val == '=')
-                pad++;
-
-            block[count] = temp;
-            count++;
-            if (count == 4)
-            {
-
-                setOutput((block[0] << 2) | (block[1] >> 4), out, &pos);
-
-                count = 0;
-                if (pad)
-                {
-                    if (pad == 1)
-                        setOutput((block[1] << 4) | (block[2] >> 2), out, &pos);
-                    else if (pad > 2)
-                        goto skip;
-
-                    break;
-                }
-                else
-                {
-                    setOutput((block[1] << 4) | (block[2] >> 2), out, &pos);
-                    setOutput((block[2] << 6) | block[3], out, &pos);
-                }
-            }
-        }
-
-        // write remaining
-        if (out.bufWrite > 0 && !writeOutput(out))
-            goto skip;
-
-        ret = true;
-
-    skip:
-        mem.release(&block);
-        return ret;
-    }
-
-    template <typename T>
-    bool encodeLast(unsigned char *base64EncBuf, const unsigned char *in, size_t len, firebase_base64_io_t<T> &out, T **pos)
+    /**
+     * Decode the Base64 chunk to the output sink (client, file, blob or OTA) through the output buffer.
+     * @param dec The decoder that keeps the incomplete quantum between chunks.
+     * @param src The Base64 chunk.
+     * @param len The length of chunk.
+     * @param out The output with its buffer and sink.
+     * @param last Set to true for the last chunk to write the remaining bits of the unpadded source.
+     */
+    bool decode(Base64Decoder &dec, const char *src, size_t len, firebase_base64_io_t<uint8_t> &out, bool last)
     {
-        if (len > 2)
-            return false;
-
-        if (!setOutput(base64EncBuf[in[0] >> 2], out, pos))
-            return false;
-
-        if (len == 1)
-        {
-            if (!setOutput(base64EncBuf[(in[0] & 0x03) << 4], out, pos))
-                return false;
-            if (!setOutput('=', out, pos))
-                return false;
-        }
-        else
+        // The source is decoded in parts that fit the output buffer.
+        const size_t step = out.bufLen / 3 * 4 - 4;
+        while (len > 0)
         {
-            if (!setOutput(base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, pos))
-                return false;
-            if (!setOutput(base64EncBuf[(in[1] & 0x0f) << 2], out, pos))
+            size_t n = len < step ? len : step;
+            out.bufWrite = dec.decode(src, n, out.outT);
+            if (!writeOutput(out))
                 return false;
+            src += n;
+            len -= n;
         }
 
-        if (!setOutput('=', out, pos))
-            return false;
-
-        return true;
-    }
-
-    template <typename T>
-    bool encode(unsigned char *base64EncBuf, uint8_t *src, size_t len, firebase_base64_io_t<T> &out, bool writeAllRemaining = true)
-    {
-        const unsigned char *end, *in;
-
-        T *pos = out.outT ? (T *)&out.outT[0] : nullptr;
-        in = src;
-        end = src + len;
-
-        while (end - in >= 3)
+        if (last)
         {
-            if (!setOutput(base64EncBuf[in[0] >> 2], out, &pos))
-                return false;
-            if (!setOutput(base64EncBuf[((in[0] & 0x03) << 4) | (in[1] >> 4)], out, &pos))
-                return false;
-            if (!setOutput(base64EncBuf[((in[1] & 0x0f) << 2) | (in[2] >> 6)], out, &pos))
-                return false;
-            if (!setOutput(base64EncBuf[in[2] & 0x3f], out, &pos))
-                return false;
-            in += 3;
+            out.bufWrite = dec.finish(out.outT);
+            return writeOutput(out);
         }
 
-        if (end - in && !encodeLast(base64EncBuf, in, end - in, out, &pos))
-            return false;
-
-        if (writeAllRemaining && out.bufWrite > 0 && !writeOutput(out))
-            return false;
-
         return true;
     }
 
 #if defined(ENABLE_FS)
-    bool decodeToFile(Memory &mem, FILEOBJ file, const char *src)
+    bool decodeToFile(Memory &mem, Base64Decoder &dec, FILEOBJ file, const char *src, size_t len, bool last)
     {
         firebase_base64_io_t<uint8_t> out;
         out.file = file;
-        uint8_t *buf = reinterpret_cast<uint8_t *>(mem.alloc(out.bufLen));
+        uint8_t *buf = reinterpret_cast<uint8_t *>(mem.alloc(out.bufLen, false, mem_alloc_chunk));
         out.outT = buf;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mem);
-        bool ret = decode<uint8_t>(mem, base64DecBuf, src, strlen(src), out);
+        bool ret = decode(dec, src, len, out, last);
         mem.release(&buf);
-        mem.release(&base64DecBuf);
         return ret;
     }
 #endif
-    bool decodeToBlob(Memory &mem, firebase_blob_writer *bWriter, const char *src)
+    bool decodeToBlob(Memory &mem, Base64Decoder &dec, firebase_blob_writer *bWriter, const char *src, size_t len, bool last)
     {
         firebase_base64_io_t<uint8_t> out;
         out.outB = bWriter;
-        uint8_t *buf = reinterpret_cast<uint8_t *>(mem.alloc(out.bufLen));
+        uint8_t *buf = reinterpret_cast<uint8_t *>(mem.alloc(out.bufLen, false, mem_alloc_chunk));
         out.outT = buf;
-        unsigned char *base64DecBuf = creatBase64DecBuffer(mem);
-        bool ret = decode<uint8_t>(mem, base64DecBuf, src, strlen(src), out);
+        bool ret = decode(dec, src, len, out, last);
         mem.release(&buf);
-        mem.release(&base64DecBuf);
         return ret;
     }
 
-    void encodeUrl(Memory &mem, char *encoded, unsigned char *string, size_t len)
+    void encodeUrl(char *encoded, const unsigned char *string, size_t len)
     {
-        size_t i;
-        char *p = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mem, true);
-
-        for (i = 0; i < len - 2; i += 3)
-        {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-            *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2) | ((int)(string[i + 2] & 0xC0) >> 6)];
-            *p++ = base64EncBuf[string[i + 2] & 0x3F];
-        }
-
-        if (i < len)
-        {
-            *p++ = base64EncBuf[(string[i] >> 2) & 0x3F];
-            if (i == (len - 1))
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4)];
-            else
-            {
-                *p++ = base64EncBuf[((string[i] & 0x3) << 4) | ((int)(string[i + 1] & 0xF0) >> 4)];
-                *p++ = base64EncBuf[((string[i + 1] & 0xF) << 2)];
-            }
-        }
-
-        *p++ = '\0';
-        mem.release(&base64EncBuf);
+        Base64Encoder enc(true);
+        size_t n = enc.encode(string, len, encoded);
+        n += enc.finish(encoded + n);
+        encoded[n] = '\0';
     }
 
-    char *encodeToChars(Memory &mem, uint8_t *src, size_t len)
+    char *encodeToChars(Memory &mem, const uint8_t *src, size_t len)
     {
         char *encoded = reinterpret_cast<char *>(mem.alloc(encodedLength(len) + 1));
-        firebase_base64_io_t<char> out;
-        out.outT = encoded;
-        unsigned char *base64EncBuf = creatBase64EncBuffer(mem, false);
-        encode<char>(base64EncBuf, (uint8_t *)src, len, out);
-        mem.release(&base64EncBuf);
+        encodeToChars(encoded, src, len);
         return encoded;
     }
+
+    // Encode to the buffer of at least encodedLength(len) + 1 bytes, return the encoded length.
+    size_t encodeToChars(char *encoded, const uint8_t *src, size_t len)
+    {
+        Base64Encoder enc;
+        size_t n = enc.encode(src, len, encoded);
+        n += enc.finish(encoded + n);
+        encoded[n] = '\0';
+        return n;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -26,6 +26,7 @@
 #define CORE_ERROR_H
 
 #include <Arduino.h>
+#include "./core/JSONTokenizer.h"
 
 #define FIREBASE_ERROR_HTTP_CODE_UNDEFINED -1000
 
@@ -124,6 +125,25 @@ private:
         err.code = 0;
     }
 
+    // Get the message of the JSON error response e.g. {"error":"..."} and {"error":{"code":...,"message":"...","status":"..."}}.
+    bool parseMessage(const String &payload)
+    {
+        JSONTokenizer tk(payload.c_str(), payload.length());
+        json_token_t token;
+        bool error_object = false;
+        while ((token = tk.next()) != json_token_none && token != json_token_error)
+        {
+            if (token == json_token_begin_object && tk.depth() == 2)
+                error_object = tk.keyIs("error");
+            else if (token == json_token_value && tk.isString() && ((tk.depth() == 1 && tk.keyIs("error")) || (tk.depth() == 2 && error_object && tk.keyIs("message"))))
+            {
+                tk.get(err.message);
+                return true;
+            }
+        }
+        return false;
+    }
+
     void setResponseError(const String &message, int code)
     {
         if (code == FIREBASE_ERROR_HTTP_CODE_PRECONDITION_FAILED)
@@ -131,7 +151,10 @@ private:
         else if (code == FIREBASE_ERROR_HTTP_CODE_UNAUTHORIZED)
             err.message = FPSTR("unauthorized");
         else if (message.length())
-            err.message = message;
+        {
+            if (!parseMessage(message))
+                err.message = message;
+        }
         else
         {
             err.message = FPSTR("HTTP Status ");
@@ -29,11 +29,22 @@
 #include "./core/AuthConfig.h"
 #include "./core/AsyncClient/AsyncClient.h"
 #include "./core/List.h"
+#include "./core/JSONTokenizer.h"
 #if defined(ENABLE_JWT)
 #include "./core/JWT.h"
 #endif
 #include "./core/Timer.h"
 
+// The seconds before the token expiry time to create and sign the next JWT in idle time.
+#if !defined(FIREBASE_JWT_PRESIGN_SEC)
+#define FIREBASE_JWT_PRESIGN_SEC 60
+#endif
+
+// The seconds before the token expiry time to refresh the token.
+#if !defined(FIREBASE_TOKEN_REFRESH_MARGIN_SEC)
+#define FIREBASE_TOKEN_REFRESH_MARGIN_SEC 120
+#endif
+
 namespace firebase
 {
 
@@ -55,8 +66,8 @@ namespace firebase
         uint16_t slot = 0;
         async_data_item_t *sData = nullptr;
         auth_data_t auth_data;
-        AsyncClientClass *aClient = nullptr;
-        uint32_t aclient_addr = 0, app_addr = 0, ref_ts = 0;
+        AsyncClientClass *aClient = nullptr, *authClient = nullptr;
+        uint32_t aclient_addr = 0, auth_client_addr = 0, app_addr = 0, ref_ts = 0;
         std::vector<uint32_t> aVec; // FirebaseApp vector
         std::vector<uint32_t> cVec; // AsyncClient vector
         AsyncResultCallback resultCb = NULL;
@@ -69,6 +80,8 @@ namespace firebase
         slot_options_t sop;
 
 #if defined(ENABLE_JWT)
+        JWTClass jwt;
+        bool jwt_presign = false;
 
         void setLastError(AsyncResult *aResult, int code, const String &message)
         {
@@ -76,112 +89,126 @@ namespace firebase
                 aResult->lastError.setLastError(code, message);
         }
 
-#endif
+        static bool presignTask(void *arg)
+        {
+            FirebaseApp *app = reinterpret_cast<FirebaseApp *>(arg);
+            return app->jwt.presign(&app->auth_data);
+        }
 
-        bool parseItem(StringUtil &sut, const String &src, String &dest, const String &name, const String &delim, int &p1, int &p2)
+        void addPresignTask()
         {
-            sut.parse(src, name, delim, p1, p2);
-            if (p1 > -1 && p2 > -1)
+            // Sign the next JWT when the async client is idle, before the token expires.
+            if (!jwt_presign && !processing && getAuthClient() && auth_data.app_token.authenticated &&
+                (auth_data.user_auth.auth_type == auth_sa_access_token || auth_data.user_auth.auth_type == auth_sa_custom_token) &&
+                auth_data.user_auth.sa.step == jwt_step_begin && ttl() > 0 && ttl() <= FIREBASE_JWT_PRESIGN_SEC)
             {
-                if (src[p1] == '"')
-                    p1++;
-                if (src[p2] == '"')
-                    p2--;
-                dest = src.substring(p1, p2);
-                p1 = p2;
-                return true;
+                jwt_presign = true;
+                getAuthClient()->addIdleTask(presignTask, this);
             }
-            p1 = 0;
-            p2 = 0;
-            return false;
         }
 
-        template <typename T = int>
-        bool parseItem(StringUtil &sut, const String &src, T &dest, const String &name, const String &delim, int &p1, int &p2)
+        void removePresignTask()
         {
-            sut.parse(src, name, delim, p1, p2);
-            if (p1 > -1 && p2 > -1)
-            {
-                if (src[p1] == '"')
-                    p1++;
-                if (src[p2] == '"')
-                    p2--;
-                dest = atoi(src.substring(p1, p2).c_str());
-                p1 = p2;
-                return true;
-            }
-            p1 = 0;
-            p2 = 0;
-            return false;
+            jwt_presign = false;
+            if (getAuthClient())
+                getAuthClient()->removeIdleTask(presignTask, this);
         }
 
+#endif
+
         bool parseToken(const String &payload)
         {
-            StringUtil sut;
-            int p1 = 0, p2 = 0;
-            auth_data.app_token.clear();
-            String token, refresh;
+            // Parse to the new token and replace the current token only when success,
+            // the current token is still used by the requests while refreshing.
+            app_token_t app_token;
+            app_token.clear();
 
-            if (payload.indexOf("\"error\"") > -1)
+            // The Identity Toolkit (idToken), Secure Token (id_token) and OAuth2 (access_token) response items.
+            enum token_item_t
             {
-                String str;
-                if (parseItem(sut, payload, str, "\"error\"", auth_data.user_auth.auth_type == auth_user_id_token || auth_data.user_auth.auth_type == auth_sa_custom_token ? "}" : ",", p1, p2))
-                {
-                    int code = 0;
-                    str = "";
-                    p1 = 0;
-                    p2 = 0;
-                    parseItem(sut, payload, code, "\"code\"", ",", p1, p2);
-                    parseItem(sut, payload, str, "\"message\"", ",", p1, p2);
-                    parseItem(sut, payload, str, "\"error_description\"", "}", p1, p2);
-                    if (str[str.length() - 1] == '"')
-                        str[str.length() - 1] = '\0';
-                    setLastError(sData ? &sData->aResult : nullptr, code, str);
-                }
-            }
-            else if (payload.indexOf("\"idToken\"") > -1)
+                item_idToken,
+                item_refreshToken,
+                item_expiresIn,
+                item_localId,
+                item_id_token,
+                item_refresh_token,
+                item_expires_in,
+                item_user_id,
+                item_access_token,
+                item_token_type,
+                item_error,
+                item_message,
+                item_error_description,
+                item_max
+            };
+
+            static const char *const keys[item_max] = {"idToken", "refreshToken", "expiresIn", "localId", "id_token", "refresh_token", "expires_in", "user_id", "access_token", "token_type", "error", "message", "error_description"};
+            String items[item_max];
+            bool has_error = false;
+            int code = 0;
+
+            JSONTokenizer tk(payload.c_str(), payload.length());
+            json_token_t token;
+            while ((token = tk.next()) != json_token_none && token != json_token_error)
             {
-                parseItem(sut, payload, auth_data.app_token.val[app_tk_ns::uid], "\"localId\"", ",", p1, p2);
-                p1 = 0;
-                p2 = 0;
-                sut.trim(auth_data.app_token.val[app_tk_ns::uid]);
-                if (parseItem(sut, payload, token, "\"idToken\"", ",", p1, p2))
+                if (token == json_token_begin_object && tk.depth() == 2 && tk.keyIs("error"))
+                    has_error = true;
+                else if (token == json_token_value && tk.depth() == 2 && has_error)
                 {
-                    sut.trim(token);
-                    parseItem(sut, payload, refresh, "\"refreshToken\"", ",", p1, p2);
-                    sut.trim(refresh);
-                    parseItem(sut, payload, auth_data.app_token.expire, "\"expiresIn\"", "}", p1, p2);
+                    if (tk.keyIs("code"))
+                        code = tk.toInt();
+                    else if (tk.keyIs(keys[item_message]))
+                        tk.get(items[item_message]);
                 }
-            }
-            else if (payload.indexOf("\"id_token\"") > -1)
-            {
-                parseItem(sut, payload, auth_data.app_token.expire, "\"expires_in\"", ",", p1, p2);
-                parseItem(sut, payload, refresh, "\"refresh_token\"", ",", p1, p2);
-                parseItem(sut, payload, token, "\"id_token\"", ",", p1, p2);
-                parseItem(sut, payload, auth_data.app_token.val[app_tk_ns::uid], "\"user_id\"", ",", p1, p2);
-                sut.trim(refresh);
-                sut.trim(token);
-                sut.trim(auth_data.app_token.val[app_tk_ns::uid]);
-            }
-            else if (payload.indexOf("\"access_token\"") > -1)
-            {
-                if (parseItem(sut, payload, token, "\"access_token\"", ",", p1, p2))
+                else if (token == json_token_value && tk.depth() == 1)
                 {
-                    parseItem(sut, payload, auth_data.app_token.expire, "\"expires_in\"", ",", p1, p2);
-                    parseItem(sut, payload, auth_data.app_token.val[app_tk_ns::type], "\"token_type\"", "}", p1, p2);
+                    for (uint8_t i = 0; i < item_max; i++)
+                    {
+                        if (i != item_message && tk.keyIs(keys[i]))
+                        {
+                            tk.get(items[i]);
+                            has_error |= i == item_error;
+                            break;
+                        }
+                    }
                 }
             }
 
-            if (token.length() > 0 && token[token.length() - 1] == '"')
-                token.remove(token.length() - 1, 1);
+            if (has_error)
+            {
+                uint8_t msg = item_error;
+                if (items[item_message].length())
+                    msg = item_message;
+                else if (items[item_error_description].length())
+                    msg = item_error_description;
+                setLastError(sData ? &sData->aResult : nullptr, code, items[msg]);
+                return false;
+            }
 
-            if (refresh.length() > 0 && refresh[refresh.length() - 1] == '"')
-                refresh.remove(refresh.length() - 1, 1);
+            uint8_t base = item_access_token;
+            if (items[item_idToken].length())
+                base = item_idToken;
+            else if (items[item_id_token].length())
+                base = item_id_token;
+            if (items[base].length() == 0)
+                return false;
 
-            auth_data.app_token.val[app_tk_ns::token] = token;
-            auth_data.app_token.val[app_tk_ns::refresh] = refresh;
-            auth_data.app_token.val[app_tk_ns::pid] = auth_data.user_auth.sa.val[sa_ns::pid];
-            return token.length() > 0;
+            app_token.val[app_tk_ns::token] = items[base];
+            if (base == item_access_token)
+            {
+                app_token.expire = atoi(items[item_expires_in].c_str());
+                app_token.val[app_tk_ns::type] = items[item_token_type];
+            }
+            else
+            {
+                // The refresh token, expiry and uid items follow the token item.
+                app_token.val[app_tk_ns::refresh] = items[base + 1];
+                app_token.expire = atoi(items[base + 2].c_str());
+                app_token.val[app_tk_ns::uid] = items[base + 3];
+            }
+            app_token.val[app_tk_ns::pid] = auth_data.user_auth.sa.val[sa_ns::pid];
+            auth_data.app_token = app_token;
+            return true;
         }
 
         AsyncClientClass *getClient()
@@ -190,6 +217,19 @@ namespace firebase
             return vec.existed(cVec, aclient_addr) ? aClient : nullptr;
         }
 
+        AsyncClientClass *getAuthClient()
+        {
+            // Use the dedicated auth client if it was set, otherwise the app's async client.
+            List vec;
+            return auth_client_addr && vec.existed(cVec, auth_client_addr) ? authClient : getClient();
+        }
+
+        bool authClientBusy()
+        {
+            // The request of the shared async client is in progress.
+            return getAuthClient() == aClient && aClient && aClient->requestInProgress();
+        }
+
         void setEvent(firebase_auth_event_type event)
         {
             auth_data.user_auth.status._event = event;
@@ -210,13 +250,14 @@ namespace firebase
 
             if (event == auth_event_error || event == auth_event_ready)
             {
+#if defined(ENABLE_JWT)
+                removePresignTask();
+#endif
                 processing = false;
-                if (getClient())
-                    stop(aClient);
+                stop(getAuthClient());
                 event = auth_event_uninitialized;
                 clearLastError(sData ? &sData->aResult : nullptr);
-                if (getClient())
-                    remove(aClient);
+                remove(getAuthClient());
             }
         }
 
@@ -327,7 +368,14 @@ namespace firebase
             if (!getClient())
                 return false;
 
-            process(aClient, sData ? &sData->aResult : nullptr, resultCb);
+            if (getAuthClient() != aClient)
+                process(aClient, nullptr, NULL);
+
+            process(getAuthClient(), sData ? &sData->aResult : nullptr, resultCb);
+
+#if defined(ENABLE_JWT)
+            addPresignTask();
+#endif
 
             if (!isExpired())
                 return true;
@@ -350,9 +398,9 @@ namespace firebase
             if (auth_data.user_auth.jwt_signing && auth_data.user_auth.jwt_ts == 0 && err_timer.remaining() == 0)
             {
                 err_timer.feed(3);
-                JWT.jwt_data.err_code = FIREBASE_ERROR_JWT_CREATION_REQUIRED;
-                JWT.jwt_data.msg = "JWT process has not begun";
-                JWT.sendErrCB(auth_data.cb, nullptr);
+                jwt.jwt_data.err_code = FIREBASE_ERROR_JWT_CREATION_REQUIRED;
+                jwt.jwt_data.msg = "JWT process has not begun";
+                jwt.sendErrCB(auth_data.cb, nullptr);
             }
 
             if (auth_data.user_auth.status._event == auth_event_uninitialized && err_timer.remaining() > 0)
@@ -379,8 +427,10 @@ namespace firebase
                     if (auth_data.user_auth.sa.step == jwt_step_begin)
                     {
                         auth_data.user_auth.sa.step = jwt_step_sign;
-                        if (getClient())
-                            stop(aClient);
+
+                        // Free the connection for signing unless the request of the shared async client is in progress.
+                        if (!authClientBusy())
+                            stop(getAuthClient());
 
                         if (auth_data.user_auth.status._event != auth_event_token_signing)
                             setEvent(auth_event_token_signing);
@@ -389,7 +439,13 @@ namespace firebase
                     }
                     else if (auth_data.user_auth.sa.step == jwt_step_sign || auth_data.user_auth.sa.step == jwt_step_ready)
                     {
-                        if (JWT.ready())
+                        // Finish the signing that was started in idle time or in the worker task.
+                        if (jwt_presign && auth_data.user_auth.sa.step == jwt_step_sign)
+                            jwt.presign(&auth_data);
+                        else if (jwt.pending() && !jwt.create())
+                            jwt.sendErrCB(auth_data.cb, nullptr);
+
+                        if (jwt.ready())
                         {
                             setEvent(auth_event_authenticating);
                             auth_data.user_auth.sa.step = jwt_step_begin;
@@ -404,21 +460,18 @@ namespace firebase
                     sop.async = true;
                     sop.auth_used = true;
 
-                    // Remove all slots except sse in case ServiceAuth and CustomAuth to free up memory.
-                    if (getClient())
-                    {
-                        for (size_t i = aClient->slotCount() - 1; i == 0; i--)
-                            aClient->removeSlot(i, false);
+                    // The current token is still valid, wait for the request of the shared async client to complete.
+                    if (auth_data.app_token.authenticated && authClientBusy())
+                        return true;
 
-                        createSlot(aClient, sop);
-                    }
+                    createSlot(getAuthClient(), sop);
 
                     if (auth_data.user_auth.auth_type == auth_sa_access_token)
                     {
 #if defined(ENABLE_SERVICE_AUTH)
                         json.addObject(sData->request.val[req_hndlr_ns::payload], "grant_type", "urn:ietf:params:oauth:grant-type:jwt-bearer", true);
-                        json.addObject(sData->request.val[req_hndlr_ns::payload], "assertion", JWT.token(), true, true);
-                        JWT.clear();
+                        json.addObject(sData->request.val[req_hndlr_ns::payload], "assertion", jwt.token(), true, true);
+                        jwt.clear();
 #endif
                     }
                     else if (auth_data.user_auth.auth_type == auth_sa_custom_token || auth_data.user_auth.auth_type == auth_custom_token)
@@ -426,8 +479,8 @@ namespace firebase
 #if defined(ENABLE_CUSTOM_AUTH)
                         if (auth_data.user_auth.auth_type == auth_sa_custom_token)
                         {
-                            json.addObject(sData->request.val[req_hndlr_ns::payload], "token", JWT.token(), true);
-                            JWT.clear();
+                            json.addObject(sData->request.val[req_hndlr_ns::payload], "token", jwt.token(), true);
+                            jwt.clear();
                         }
 #endif
 #if defined(ENABLE_CUSTOM_TOKEN)
@@ -461,8 +514,7 @@ namespace firebase
                         else
                             extras += auth_data.user_auth.user.val[user_ns::api_key];
                     }
-                    if (getClient())
-                        newRequest(aClient, sop, subdomain, extras, resultCb);
+                    newRequest(getAuthClient(), sop, subdomain, extras, resultCb);
                     extras.remove(0, extras.length());
                     host.remove(0, host.length());
                     setEvent(auth_event_auth_request_sent);
@@ -484,8 +536,10 @@ namespace firebase
                     sop.async = true;
                     sop.auth_used = true;
 
-                    if (getClient())
-                        createSlot(aClient, sop);
+                    if (auth_data.app_token.authenticated && authClientBusy())
+                        return true;
+
+                    createSlot(getAuthClient(), sop);
 
                     if (auth_data.user_auth.task_type == firebase_core_auth_task_type_reset_password || auth_data.user_auth.task_type == firebase_core_auth_task_type_send_verify_email)
                     {
@@ -533,8 +587,7 @@ namespace firebase
                     else
                         extras += auth_data.user_auth.user.val[user_ns::api_key];
 
-                    if (getClient())
-                        newRequest(aClient, sop, subdomain, extras, resultCb);
+                    newRequest(getAuthClient(), sop, subdomain, extras, resultCb);
                     extras.remove(0, extras.length());
                     host.remove(0, host.length());
                     setEvent(auth_event_auth_request_sent);
@@ -572,7 +625,7 @@ namespace firebase
                     if (parseToken(sData->response.val[res_hndlr_ns::payload].c_str()))
                     {
                         sData->response.val[res_hndlr_ns::payload].remove(0, sData->response.val[res_hndlr_ns::payload].length());
-                        auth_timer.feed(expire && expire < auth_data.app_token.expire ? expire : auth_data.app_token.expire - 2 * 60);
+                        auth_timer.feed(expire && expire < auth_data.app_token.expire ? expire : (auth_data.app_token.expire > FIREBASE_TOKEN_REFRESH_MARGIN_SEC ? auth_data.app_token.expire - FIREBASE_TOKEN_REFRESH_MARGIN_SEC : auth_data.app_token.expire / 2));
                         auth_data.app_token.authenticated = true;
                         if (getClient())
                             aClient->setAuthTs(millis());
@@ -595,8 +648,28 @@ namespace firebase
         {
             app_addr = reinterpret_cast<uint32_t>(this);
             vec.addRemoveList(aVec, app_addr, true);
+#if defined(ENABLE_JWT)
+            auth_data.jwt = &jwt;
+#endif
+        };
+        ~FirebaseApp()
+        {
+#if defined(ENABLE_JWT)
+            removePresignTask();
+#endif
+            vec.addRemoveList(aVec, app_addr, false);
         };
-        ~FirebaseApp() { vec.addRemoveList(aVec, app_addr, false); };
+
+        void setAuthClient(AsyncClientClass &authClient)
+        {
+            this->authClient = &authClient;
+            auth_client_addr = reinterpret_cast<uint32_t>(&authClient);
+            authClient.addRemoveClientVec(reinterpret_cast<uint32_t>(&cVec), true);
+        }
+
+#if defined(ENABLE_JWT) && defined(ENABLE_FS)
+        void setKeyCache(file_config_data &keyFile) { jwt.setKeyCache(keyFile); }
+#endif
 
         bool isInitialized() const { return auth_data.user_auth.initialized; }
 
@@ -0,0 +1,108 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef CORE_IDLE_QUEUE_H
+#define CORE_IDLE_QUEUE_H
+#include <Arduino.h>
+#include <vector>
+
+/**
+ * Idle Task Callback.
+ * @param arg The user data that assigned to the task.
+ * @return true when the task was finished and should be removed from the queue.
+ *
+ * The task will be called repeatedly when the async client is idle (no slot pending).
+ * The task should do a small amount of work for each call.
+ */
+typedef bool (*IdleTaskCallback)(void *arg);
+
+namespace firebase
+{
+    struct idle_task_t
+    {
+    public:
+        IdleTaskCallback cb = NULL;
+        void *arg = nullptr;
+    };
+
+    class IdleQueue
+    {
+    private:
+        std::vector<idle_task_t> tasks;
+        size_t index = 0;
+
+    public:
+        IdleQueue() {}
+        ~IdleQueue() { tasks.clear(); }
+
+        void add(IdleTaskCallback cb, void *arg = nullptr)
+        {
+            if (!cb)
+                return;
+
+            for (size_t i = 0; i < tasks.size(); i++)
+            {
+                if (tasks[i].cb == cb && tasks[i].arg == arg)
+                    return;
+            }
+
+            idle_task_t task;
+            task.cb = cb;
+            task.arg = arg;
+            tasks.push_back(task);
+        }
+
+        void remove(IdleTaskCallback cb, void *arg = nullptr)
+        {
+            for (size_t i = tasks.size(); i > 0; i--)
+            {
+                if (tasks[i - 1].cb == cb && tasks[i - 1].arg == arg)
+                    tasks.erase(tasks.begin() + i - 1);
+            }
+        }
+
+        size_t size() const { return tasks.size(); }
+
+        // Runs one task in round robin, returns false when there is no task.
+        bool run()
+        {
+            if (tasks.size() == 0)
+                return false;
+
+            if (index >= tasks.size())
+                index = 0;
+
+            idle_task_t task = tasks[index];
+
+            if (task.cb(task.arg))
+                remove(task.cb, task.arg);
+            else
+                index++;
+
+            return true;
+        }
+    };
+};
+
+#endif
@@ -0,0 +1,181 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef CORE_JSON_INDEX_H
+#define CORE_JSON_INDEX_H
+
+#include <Arduino.h>
+#include <vector>
+#include "./Config.h"
+#include "./core/JSONTokenizer.h"
+
+/**
+ * The structural index of JSON content.
+ *
+ * The index is the list of nodes in document order, each node keeps the positions of its key and value in the content
+ * and the index of the node that follows its subtree, which is used to skip to the next sibling.
+ * The content is not copied, the index should be cleared when the content was changed.
+ */
+class JSONIndex
+{
+private:
+    enum json_node_type_t
+    {
+        json_node_literal,
+        json_node_string,
+        json_node_object,
+        json_node_array
+    };
+
+    struct json_node_t
+    {
+        uint32_t key_pos = 0, val_pos = 0, val_len = 0, next = 0;
+        uint16_t key_len = 0;
+        uint8_t type = json_node_literal;
+    };
+
+    std::vector<json_node_t> nodes;
+    bool built = false;
+
+    void build(const String &content)
+    {
+        nodes.clear();
+        built = true;
+
+        JSONTokenizer tk(content.c_str(), content.length());
+        json_token_t token;
+        uint32_t stack[64];
+        uint8_t level = 0;
+        json_node_t node;
+
+        while ((token = tk.next()) != json_token_none)
+        {
+            if (token == json_token_error)
+            {
+                nodes.clear();
+                return;
+            }
+
+            if (token == json_token_key)
+            {
+                node.key_pos = tk.position();
+                node.key_len = tk.keyLength();
+                continue;
+            }
+
+            if (token == json_token_end_object || token == json_token_end_array)
+            {
+                json_node_t &parent = nodes[stack[--level]];
+                parent.val_len = tk.position() + 1 - parent.val_pos;
+                parent.next = nodes.size();
+                continue;
+            }
+
+            node.val_pos = tk.position();
+            node.val_len = tk.length();
+            node.next = nodes.size() + 1;
+            node.type = json_node_literal;
+            if (token == json_token_value && tk.isString())
+                node.type = json_node_string;
+            else if (token == json_token_begin_object)
+                node.type = json_node_object;
+            else if (token == json_token_begin_array)
+                node.type = json_node_array;
+
+            if (node.type >= json_node_object)
+                stack[level++] = nodes.size();
+            nodes.push_back(node);
+            node.key_pos = 0;
+            node.key_len = 0;
+        }
+    }
+
+public:
+    JSONIndex() {}
+
+    /**
+     * Find the value of the path.
+     * @param content The JSON content.
+     * @param path The path of the value e.g. "a/b/c", the array element is selected with its index e.g. "items/0/name".
+     * @param pos The position of value in the content, the string value without quotes.
+     * @param len The length of value.
+     * @param isString The value is the string.
+     * @return bool The value was found.
+     */
+    bool find(const String &content, const String &path, size_t &pos, size_t &len, bool &isString)
+    {
+        if (!built)
+            build(content);
+
+        if (nodes.size() == 0)
+            return false;
+
+        const char *c = content.c_str(), *p = path.c_str();
+        size_t cur = 0;
+
+        while (*p)
+        {
+            if (*p == '/')
+            {
+                p++;
+                continue;
+            }
+
+            size_t seg = 0;
+            while (p[seg] && p[seg] != '/')
+                seg++;
+
+            const json_node_t &parent = nodes[cur];
+            if (parent.type < json_node_object)
+                return false;
+
+            size_t index = parent.type == json_node_array ? atoi(p) : 0, i = cur + 1;
+            for (; i < parent.next; i = nodes[i].next)
+            {
+                if (parent.type == json_node_array ? (index-- == 0) : (nodes[i].key_len == seg && strncmp(c + nodes[i].key_pos, p, seg) == 0))
+                    break;
+            }
+
+            if (i >= parent.next)
+                return false;
+
+            cur = i;
+            p += seg;
+        }
+
+        pos = nodes[cur].val_pos;
+        len = nodes[cur].val_len;
+        isString = nodes[cur].type == json_node_string;
+        return true;
+    }
+
+    // Clear the index, it will be built again when the path was queried.
+    void clear()
+    {
+        std::vector<json_node_t>().swap(nodes);
+        built = false;
+    }
+};
+
+#endif
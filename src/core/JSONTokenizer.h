@@ -0,0 +1,492 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef CORE_JSON_TOKENIZER_H
+#define CORE_JSON_TOKENIZER_H
+
+#include <Arduino.h>
+#include "./Config.h"
+
+// The vectorized scanning of string content and whitespace on host targets.
+#if !defined(FIREBASE_DISABLE_SIMD)
+#if defined(__AVX2__)
+#define FIREBASE_JSON_SCAN_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define FIREBASE_JSON_SCAN_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define FIREBASE_JSON_SCAN_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+// The maximum length of the key that can be compared with JSONTokenizer::keyIs.
+#if !defined(FIREBASE_JSON_KEY_SIZE)
+#define FIREBASE_JSON_KEY_SIZE 32
+#endif
+
+enum json_token_t
+{
+    json_token_none,
+    json_token_begin_object,
+    json_token_end_object,
+    json_token_begin_array,
+    json_token_end_array,
+    json_token_key,
+    json_token_value,
+    json_token_error
+};
+
+/**
+ * The resumable JSON tokenizer.
+ *
+ * The content is fed chunk by chunk with feed() and the tokens are pulled with next()
+ * until json_token_none is returned, which means the chunk was consumed and the next chunk is needed.
+ *
+ * The tokenizer does not allocate memory, the value data points to the fed chunk.
+ * The string value or literal that spans over the chunks is returned in parts with partial() is true.
+ * The last key is kept in the internal buffer for matching with the following value.
+ */
+class JSONTokenizer
+{
+private:
+    enum tokenizer_state_t
+    {
+        tokenizer_state_value,
+        tokenizer_state_key,
+        tokenizer_state_string,
+        tokenizer_state_literal,
+        tokenizer_state_error
+    };
+
+    const char *buf = nullptr;
+    size_t len = 0, pos = 0, offset = 0;
+    // The container stack, the bit is set for object.
+    uint64_t stack = 0;
+    uint8_t level = 0;
+    uint8_t state = tokenizer_state_value;
+    bool expect_key = false, escape = false, str = false, part = false;
+    char key_buf[FIREBASE_JSON_KEY_SIZE];
+    size_t key_len = 0, key_pos = 0;
+    const char *tk = nullptr;
+    size_t tk_len = 0, tk_pos = 0;
+
+    bool inObject() const { return level > 0 && (stack >> (level - 1)) & 1; }
+
+    json_token_t push(bool object)
+    {
+        if (level == 64)
+            return setError();
+        if (object)
+            stack |= (uint64_t)1 << level;
+        else
+            stack &= ~((uint64_t)1 << level);
+        level++;
+        expect_key = object;
+        return setToken(pos++, 1, false, object ? json_token_begin_object : json_token_begin_array);
+    }
+
+    json_token_t pop(bool object)
+    {
+        if (level == 0 || inObject() != object)
+            return setError();
+        level--;
+        expect_key = false;
+        return setToken(pos++, 1, false, object ? json_token_end_object : json_token_end_array);
+    }
+
+    json_token_t setToken(size_t start, size_t n, bool partial, json_token_t token)
+    {
+        tk = buf + start;
+        tk_len = n;
+        tk_pos = offset + start;
+        part = partial;
+        return token;
+    }
+
+    json_token_t setError()
+    {
+        state = tokenizer_state_error;
+        return json_token_error;
+    }
+
+    // Scan to the closing quote, returns true when found.
+    bool scanString()
+    {
+        while (pos < len)
+        {
+            if (escape)
+            {
+                escape = false;
+                pos++;
+                continue;
+            }
+            pos += findQuote(buf + pos, len - pos);
+            if (pos == len)
+                return false;
+            if (buf[pos] == '"')
+                return true;
+            escape = true;
+            pos++;
+        }
+        return false;
+    }
+
+    static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+    // Get the offset of the first quote or backslash, or n when not found.
+    static size_t findQuote(const char *p, size_t n)
+    {
+        size_t i = 0;
+#if defined(FIREBASE_JSON_SCAN_AVX2)
+        const __m256i q = _mm256_set1_epi8('"'), b = _mm256_set1_epi8('\\');
+        for (; i + 32 <= n; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+            uint32_t m = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, q), _mm256_cmpeq_epi8(v, b)));
+            if (m)
+                return i + __builtin_ctz(m);
+        }
+#elif defined(FIREBASE_JSON_SCAN_SSE2)
+        const __m128i q = _mm_set1_epi8('"'), b = _mm_set1_epi8('\\');
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+            uint32_t m = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, q), _mm_cmpeq_epi8(v, b)));
+            if (m)
+                return i + __builtin_ctz(m);
+        }
+#elif defined(FIREBASE_JSON_SCAN_NEON)
+        const uint8x16_t q = vdupq_n_u8('"'), b = vdupq_n_u8('\\');
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x16_t v = vld1q_u8((const uint8_t *)(p + i));
+            if (vmaxvq_u8(vorrq_u8(vceqq_u8(v, q), vceqq_u8(v, b))))
+                break;
+        }
+#endif
+        for (; i < n; i++)
+        {
+            if (p[i] == '"' || p[i] == '\\')
+                return i;
+        }
+        return n;
+    }
+
+    // Get the offset of the first non-whitespace character, or n when not found.
+    static size_t skipSpace(const char *p, size_t n)
+    {
+        size_t i = 0;
+#if defined(FIREBASE_JSON_SCAN_AVX2)
+        const __m256i sp = _mm256_set1_epi8(' '), lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r'), tb = _mm256_set1_epi8('\t');
+        for (; i + 32 <= n; i += 32)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+            __m256i w = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, sp), _mm256_cmpeq_epi8(v, lf)), _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), _mm256_cmpeq_epi8(v, tb)));
+            uint32_t m = ~(uint32_t)_mm256_movemask_epi8(w);
+            if (m)
+                return i + __builtin_ctz(m);
+        }
+#elif defined(FIREBASE_JSON_SCAN_SSE2)
+        const __m128i sp = _mm_set1_epi8(' '), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r'), tb = _mm_set1_epi8('\t');
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+            __m128i w = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, lf)), _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, tb)));
+            uint32_t m = ~(uint32_t)_mm_movemask_epi8(w) & 0xffff;
+            if (m)
+                return i + __builtin_ctz(m);
+        }
+#elif defined(FIREBASE_JSON_SCAN_NEON)
+        const uint8x16_t sp = vdupq_n_u8(' '), lf = vdupq_n_u8('\n'), cr = vdupq_n_u8('\r'), tb = vdupq_n_u8('\t');
+        for (; i + 16 <= n; i += 16)
+        {
+            uint8x16_t v = vld1q_u8((const uint8_t *)(p + i));
+            uint8x16_t w = vorrq_u8(vorrq_u8(vceqq_u8(v, sp), vceqq_u8(v, lf)), vorrq_u8(vceqq_u8(v, cr), vceqq_u8(v, tb)));
+            if (vminvq_u8(w) == 0)
+                break;
+        }
+#endif
+        while (i < n && isSpace(p[i]))
+            i++;
+        return i;
+    }
+
+    bool isDelimiter(char c) const { return c == ',' || c == ']' || c == '}' || c == ':' || c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    static int hex(char c)
+    {
+        if (c >= '0' && c <= '9')
+            return c - '0';
+        if (c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+
+public:
+    JSONTokenizer() {}
+
+    /**
+     * Create the tokenizer and feed the whole content.
+     * @param data The JSON content.
+     * @param size The length of content.
+     */
+    JSONTokenizer(const char *data, size_t size) { feed(data, size); }
+
+    /**
+     * Feed the next chunk of content.
+     * The previous chunk should be consumed i.e. next() returned json_token_none.
+     * @param data The chunk data.
+     * @param size The length of chunk data.
+     */
+    void feed(const char *data, size_t size)
+    {
+        offset += len;
+        buf = data;
+        len = size;
+        pos = 0;
+    }
+
+    /**
+     * Get the next token.
+     * @return json_token_t The token type, json_token_none when the chunk was consumed.
+     */
+    json_token_t next()
+    {
+        while (pos < len)
+        {
+            size_t start = pos;
+            switch (state)
+            {
+            case tokenizer_state_key:
+                scanString();
+                for (size_t i = start; i < pos; i++, key_len++)
+                {
+                    if (key_len < FIREBASE_JSON_KEY_SIZE - 1)
+                        key_buf[key_len] = buf[i];
+                }
+                if (pos == len)
+                    return json_token_none;
+                pos++;
+                state = tokenizer_state_value;
+                key_buf[key_len < FIREBASE_JSON_KEY_SIZE ? key_len : FIREBASE_JSON_KEY_SIZE - 1] = '\0';
+                tk = key_buf;
+                tk_len = key_len < FIREBASE_JSON_KEY_SIZE ? key_len : FIREBASE_JSON_KEY_SIZE - 1;
+                tk_pos = key_pos;
+                part = false;
+                return json_token_key;
+
+            case tokenizer_state_string:
+                if (scanString())
+                {
+                    state = tokenizer_state_value;
+                    return setToken(start, pos++ - start, false, json_token_value);
+                }
+                if (pos > start)
+                    return setToken(start, pos - start, true, json_token_value);
+                return json_token_none;
+
+            case tokenizer_state_literal:
+                while (pos < len && !isDelimiter(buf[pos]))
+                    pos++;
+                if (pos < len)
+                {
+                    state = tokenizer_state_value;
+                    return setToken(start, pos - start, false, json_token_value);
+                }
+                return setToken(start, pos - start, true, json_token_value);
+
+            case tokenizer_state_error:
+                return json_token_error;
+
+            default:
+                switch (buf[pos])
+                {
+                case ' ':
+                case '\t':
+                case '\r':
+                case '\n':
+                    pos += skipSpace(buf + pos, len - pos);
+                    break;
+                case ':':
+                    pos++;
+                    break;
+                case ',':
+                    expect_key = inObject();
+                    pos++;
+                    break;
+                case '{':
+                    return push(true);
+                case '[':
+                    return push(false);
+                case '}':
+                    return pop(true);
+                case ']':
+                    return pop(false);
+                case '"':
+                    pos++;
+                    str = !expect_key;
+                    state = expect_key ? tokenizer_state_key : tokenizer_state_string;
+                    if (expect_key)
+                    {
+                        key_len = 0;
+                        key_pos = offset + pos;
+                    }
+                    expect_key = false;
+                    break;
+                default:
+                    str = false;
+                    state = tokenizer_state_literal;
+                    break;
+                }
+                break;
+            }
+        }
+        return json_token_none;
+    }
+
+    /**
+     * Get the token data.
+     * The key without quotes, the string value content without quotes or the literal e.g. number, true, false and null.
+     */
+    const char *data() const { return tk; }
+
+    // The length of token data.
+    size_t length() const { return tk_len; }
+
+    // The position of token data in the content, counted from the first fed chunk.
+    size_t position() const { return tk_pos; }
+
+    // The nesting level of the current token, the members of the root object are at level 1.
+    uint8_t depth() const { return level; }
+
+    // The value is the string.
+    bool isString() const { return str; }
+
+    // The token data is only part of the string value or literal, the rest will be returned with the next chunk.
+    bool partial() const { return part; }
+
+    // The length of the last key in the content, the key data is truncated to FIREBASE_JSON_KEY_SIZE - 1.
+    size_t keyLength() const { return key_len; }
+
+    // The last key is equal to the name.
+    bool keyIs(const char *name) const { return key_len < FIREBASE_JSON_KEY_SIZE && strcmp(key_buf, name) == 0; }
+
+    // The token data is equal to the text.
+    bool is(const char *text) const { return strlen(text) == tk_len && strncmp(tk, text, tk_len) == 0; }
+
+    /**
+     * Append the token data to the string as it is.
+     * To collect the string value that was returned in parts, append all parts and then call unescape().
+     * @param out The string to append.
+     */
+    void append(String &out) const { out.concat(tk, tk_len); }
+
+    /**
+     * Get the token data, the escaped characters of the string value are unescaped.
+     * @param out The string to store the token data.
+     */
+    void get(String &out) const
+    {
+        out.remove(0, out.length());
+        append(out);
+        if (str)
+            unescape(out);
+    }
+
+    /**
+     * Unescape the JSON string in place.
+     * @param s The string to unescape.
+     * @param index The index to start.
+     */
+    static void unescape(String &s, size_t index = 0)
+    {
+        size_t w = index, n = s.length();
+        for (size_t i = index; i < n; i++)
+        {
+            char c = s[i];
+            if (c != '\\' || i + 1 == n)
+            {
+                s[w++] = c;
+                continue;
+            }
+
+            c = s[++i];
+            if (c == 'n')
+                s[w++] = '\n';
+            else if (c == 'r')
+                s[w++] = '\r';
+            else if (c == 't')
+                s[w++] = '\t';
+            else if (c == 'b')
+                s[w++] = '\b';
+            else if (c == 'f')
+                s[w++] = '\f';
+            else if (c == 'u' && i + 4 < n && hex(s[i + 1]) > -1 && hex(s[i + 2]) > -1 && hex(s[i + 3]) > -1 && hex(s[i + 4]) > -1)
+            {
+                uint16_t u = hex(s[i + 1]) << 12 | hex(s[i + 2]) << 8 | hex(s[i + 3]) << 4 | hex(s[i + 4]);
+                i += 4;
+                // UTF-8 encoding of the basic multilingual plane code point, it is never longer than the escape sequence.
+                if (u < 0x80)
+                    s[w++] = (char)u;
+                else if (u < 0x800)
+                {
+                    s[w++] = (char)(0xc0 | (u >> 6));
+                    s[w++] = (char)(0x80 | (u & 0x3f));
+                }
+                else
+                {
+                    s[w++] = (char)(0xe0 | (u >> 12));
+                    s[w++] = (char)(0x80 | ((u >> 6) & 0x3f));
+                    s[w++] = (char)(0x80 | (u & 0x3f));
+                }
+            }
+            else
+                s[w++] = c;
+        }
+        s.remove(w);
+    }
+
+    // Get the token data as integer.
+    int toInt() const { return atoi(tk); }
+
+    // Reset the tokenizer for the new content.
+    void clear()
+    {
+        buf = nullptr;
+        len = pos = offset = 0;
+        stack = 0;
+        level = 0;
+        state = tokenizer_state_value;
+        expect_key = escape = str = part = false;
+        key_len = key_pos = 0;
+        tk = nullptr;
+        tk_len = tk_pos = 0;
+    }
+};
+
+#endif
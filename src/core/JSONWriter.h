@@ -0,0 +1,203 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef CORE_JSON_WRITER_H
+#define CORE_JSON_WRITER_H
+
+#include <Arduino.h>
+#include "./Config.h"
+#include "./core/AsyncResult/Value.h"
+
+class JSONWriter;
+
+/**
+ * JSON Writer Callback.
+ * @param writer The JSONWriter object to write the JSON content.
+ *
+ * The callback will be called twice, to calculate the content length and to write the content while sending.
+ * It should write the same content every time it was called and should not depend on the number of calls.
+ * The content is sent in one pass, the loop is blocked until all content was sent (also for the async request).
+ * The request fails when the written content is not the same length as calculated.
+ */
+typedef void (*JSONWriterCallback)(JSONWriter &writer);
+
+// The callback that sends the full buffer while writing, returns false to stop sending.
+typedef bool (*JSONWriterFlushCallback)(void *arg, uint8_t *data, size_t len);
+
+class JSONWriter
+{
+    friend class AsyncClientClass;
+
+private:
+    ValueConverter vcon;
+    String val;
+    uint8_t *buf = nullptr;
+    size_t bufSize = 0, pos = 0, filled = 0;
+    bool first = true, failed = false;
+    JSONWriterFlushCallback flush_cb = NULL;
+    void *flush_arg = nullptr;
+
+    void put(const char *s, size_t len)
+    {
+        pos += len;
+        if (!buf || failed)
+            return;
+
+        // Send the buffer when it is full and continue writing from the start of buffer.
+        while (len > 0)
+        {
+            size_t n = bufSize - filled < len ? bufSize - filled : len;
+            memcpy(buf + filled, s, n);
+            filled += n;
+            s += n;
+            len -= n;
+            if (filled == bufSize && !flush())
+                return;
+        }
+    }
+
+    bool flush()
+    {
+        if (filled > 0 && !failed && (!flush_cb || !flush_cb(flush_arg, buf, filled)))
+            failed = true;
+        filled = 0;
+        return !failed;
+    }
+
+    void put(char c) { put(&c, 1); }
+
+    void addKey(const char *key)
+    {
+        if (!first)
+            put(',');
+        first = false;
+        if (key)
+        {
+            put('"');
+            put(key, strlen(key));
+            put("\":", 2);
+        }
+    }
+
+    // Returns the length of content.
+    static size_t measure(JSONWriterCallback cb)
+    {
+        JSONWriter writer;
+        if (cb)
+            cb(writer);
+        return writer.pos;
+    }
+
+    // Writes the content in one pass, the buffer is passed to the flush callback every time it is full
+    // and after the content was written. Returns false when the flush callback failed.
+    bool write(JSONWriterCallback cb, uint8_t *buf, size_t size, JSONWriterFlushCallback flushCb, void *arg)
+    {
+        this->buf = buf;
+        bufSize = size;
+        flush_cb = flushCb;
+        flush_arg = arg;
+        pos = 0;
+        filled = 0;
+        first = true;
+        failed = false;
+        if (cb)
+            cb(*this);
+        return flush();
+    }
+
+public:
+    JSONWriter() {}
+    ~JSONWriter() {}
+
+    /**
+     * Begin the JSON object.
+     * @param key The member name of this object in the parent object or nullptr for the root object and the array element.
+     */
+    void beginObject(const char *key = nullptr)
+    {
+        addKey(key);
+        put('{');
+        first = true;
+    }
+
+    /**
+     * End the JSON object.
+     */
+    void endObject()
+    {
+        put('}');
+        first = false;
+    }
+
+    /**
+     * Begin the JSON array.
+     * @param key The member name of this array in the parent object or nullptr for the root array and the array element.
+     */
+    void beginArray(const char *key = nullptr)
+    {
+        addKey(key);
+        put('[');
+        first = true;
+    }
+
+    /**
+     * End the JSON array.
+     */
+    void endArray()
+    {
+        put(']');
+        first = false;
+    }
+
+    /**
+     * Add the object member.
+     * @param key The member name.
+     * @param value The value of member.
+     *
+     * The value type can be primitive types, Arduino String, string_t, number_t, boolean_t and object_t.
+     */
+    template <typename T = const char *>
+    void add(const char *key, T value)
+    {
+        addKey(key);
+        vcon.getVal<T>(val, value);
+        put(val.c_str(), val.length());
+    }
+
+    /**
+     * Add the array element.
+     * @param value The array element value.
+     *
+     * The value type can be primitive types, Arduino String, string_t, number_t, boolean_t and object_t.
+     */
+    template <typename T = const char *>
+    void add(T value)
+    {
+        addKey(nullptr);
+        vcon.getVal<T>(val, value);
+        put(val.c_str(), val.length());
+    }
+};
+
+#endif
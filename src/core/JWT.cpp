@@ -51,6 +51,7 @@ extern "C"
 JWTClass::JWTClass()
 {
     err_timer.feed(1);
+    memset(&rsa_key, 0, sizeof(rsa_key));
 #if defined(USE_EMBED_SSL_ENGINE)
     stack_thunk_add_ref();
 #endif
@@ -58,6 +59,10 @@ JWTClass::JWTClass()
 
 JWTClass::~JWTClass()
 {
+#if defined(FIREBASE_JWT_WORKER)
+    waitWorker();
+#endif
+    clearKey();
 #if defined(USE_EMBED_SSL_ENGINE)
     stack_thunk_del_ref();
 #endif
@@ -84,6 +89,10 @@ bool JWTClass::ready()
 }
 bool JWTClass::loop(auth_data_t *auth_data)
 {
+    // Use the signer of the app, the apps can sign their tokens independently.
+    if (auth_data && auth_data->jwt && auth_data->jwt != this)
+        return auth_data->jwt->loop(auth_data);
+
     if (auth_data && auth_data->user_auth.jwt_signing)
     {
         bool ret = begin(auth_data);
@@ -120,17 +129,45 @@ void JWTClass::sendErrCB(AsyncResultCallback cb, AsyncResult *aResult)
 
 bool JWTClass::begin(auth_data_t *auth_data)
 {
-    if (processing || !auth_data)
+    if (processing || pending() || !auth_data)
         return false;
     processing = true;
     this->auth_data = auth_data;
-    this->auth_data->app_token.clear();
+    // The current token is kept and replaced when the new token is received.
     this->auth_data->user_auth.jwt_ts = millis();
     this->auth_data->user_auth.jwt_signing = false;
     this->auth_data->user_auth.sa.step = jwt_step_begin;
     return create();
 }
 
+bool JWTClass::presign(auth_data_t *auth_data)
+{
+    // Create and sign the next token while the current token is still valid.
+    if (!auth_data || processing)
+        return false;
+
+    bool ret = false;
+    if (auth_data->user_auth.sa.step == jwt_step_begin)
+        ret = begin(auth_data);
+    else if (auth_data->user_auth.sa.step == jwt_step_sign)
+    {
+        this->auth_data = auth_data;
+        ret = create();
+    }
+    else
+        return true;
+
+    // Let the token request do the signing again.
+    if (!ret)
+    {
+        auth_data->user_auth.sa.step = jwt_step_begin;
+        auth_data->user_auth.jwt_ts = 0;
+        return true;
+    }
+
+    return auth_data->user_auth.sa.step == jwt_step_ready;
+}
+
 bool JWTClass::create()
 {
 
@@ -245,7 +282,7 @@ bool JWTClass::create()
 
         len = but.encodedLength(payload.length());
         char *buf = reinterpret_cast<char *>(mem.alloc(len));
-        but.encodeUrl(mem, buf, (unsigned char *)payload.c_str(), payload.length());
+        but.encodeUrl(buf, (unsigned char *)payload.c_str(), payload.length());
         payload.remove(0, payload.length());
         jwt_data.token += '.';
         jwt_data.token += buf;
@@ -256,7 +293,7 @@ bool JWTClass::create()
         br_sha256_init(&mc);
         br_sha256_update(&mc, jwt_data.token.c_str(), jwt_data.token.length());
         if (!jwt_data.hash)
-            jwt_data.hash = reinterpret_cast<char *>(mem.alloc(32));
+            jwt_data.hash = reinterpret_cast<char *>(mem.alloc(32, true, mem_alloc_scratch));
         br_sha256_out(&mc, jwt_data.hash);
         jwt_data.token += '.';
 
@@ -264,75 +301,319 @@ bool JWTClass::create()
     }
     else if (auth_data->user_auth.sa.step == jwt_step_sign)
     {
-        // RSA private key
-        PrivateKey *pk = nullptr;
-        sys_idle();
-        // parse priv key
-        if (jwt_data.pk.length() > 0)
-            pk = new PrivateKey(jwt_data.pk.c_str());
-        else if (auth_data->user_auth.sa.val[sa_ns::pk].length() > 0)
-            pk = new PrivateKey(auth_data->user_auth.sa.val[sa_ns::pk].c_str());
-
-        jwt_data.pk.remove(0, jwt_data.pk.length());
-
-        if (!pk)
-        {
-            jwt_data.err_code = FIREBASE_ERROR_TOKEN_PARSE_PK;
-            jwt_data.msg = (const char *)FPSTR("JWT, private key parsing fail");
-            auth_data->user_auth.sa.step = jwt_step_error;
-            return exit(false);
-        }
+#if defined(FIREBASE_JWT_WORKER)
+        // The token is signed in the worker task, its result is taken in the next call.
+        if (worker_state == jwt_worker_running)
+            return true;
 
-        if (!pk->isRSA())
+        if (worker_state == jwt_worker_done)
         {
-            delete pk;
-            pk = nullptr;
-            jwt_data.err_code = FIREBASE_ERROR_TOKEN_PARSE_PK;
-            jwt_data.msg = (const char *)FPSTR("JWT, invalid RSA private key");
-            auth_data->user_auth.sa.step = jwt_step_error;
-            return exit(false);
+            worker_state = jwt_worker_idle;
+#if defined(FIREBASE_JWT_WORKER_THREAD)
+            worker.join();
+#endif
+            return signResult(worker_ret);
         }
 
-        const br_rsa_private_key *br_rsa_key = pk->getRSA();
+        // The key is decoded (or read from file) here, the worker task only signs.
+        if (!loadKey())
+            return signResult(false);
+
+        if (startWorker())
+            return true;
+#endif
+        return signResult(sign());
+    }
+#endif
+
+    return exit(true);
+}
+
+bool JWTClass::sign()
+{
+#if !defined(USE_LEGACY_TOKEN_ONLY) && !defined(FIREBASE_USE_LEGACY_TOKEN_ONLY)
+    if (!loadKey())
+        return false;
 
-        // generate RSA signature from private key and message digest
-        sys_idle();
-        if (!jwt_data.signature)
-            jwt_data.signature = reinterpret_cast<unsigned char *>(mem.alloc(256));
-        int ret = br_rsa_i15_pkcs1_sign(BR_HASH_OID_SHA256, (const unsigned char *)jwt_data.hash, br_sha256_SIZE, br_rsa_key, jwt_data.signature);
-        sys_idle();
+    // generate RSA signature from private key and message digest
+    sys_idle();
+    if (!jwt_data.signature)
+        jwt_data.signature = reinterpret_cast<unsigned char *>(mem.alloc(256, true, mem_alloc_scratch));
+    int ret = br_rsa_i15_pkcs1_sign(BR_HASH_OID_SHA256, (const unsigned char *)jwt_data.hash, br_sha256_SIZE, &rsa_key, jwt_data.signature);
+    sys_idle();
 
-        if (jwt_data.hash)
-            mem.release(&jwt_data.hash);
+    if (jwt_data.hash)
+        mem.release(&jwt_data.hash);
 
-        size_t len = but.encodedLength(256);
-        char *buf = reinterpret_cast<char *>(mem.alloc(len));
-        but.encodeUrl(mem, buf, jwt_data.signature, 256);
+    size_t len = but.encodedLength(256);
+    char *buf = reinterpret_cast<char *>(mem.alloc(len));
+    but.encodeUrl(buf, jwt_data.signature, 256);
 
+    // get the signed JWT
+    if (ret > 0)
+    {
+        jwt_data.token += buf;
+        mem.release(&buf);
+        return true;
+    }
+    else
+    {
+        mem.release(&buf);
+        jwt_data.err_code = FIREBASE_ERROR_TOKEN_SIGN;
+        jwt_data.msg = (const char *)FPSTR("JWT, token signing fail");
+        return false;
+    }
+#endif
+    return false;
+}
+
+uint32_t JWTClass::keyId(const char *pem)
+{
+    // FNV-1a hash of the PEM key to detect the key change.
+    uint32_t h = 2166136261UL;
+    while (pem && *pem)
+    {
+        h ^= (uint8_t)*pem++;
+        h *= 16777619UL;
+    }
+    return h ? h : 1;
+}
+
+bool JWTClass::allocKey(size_t size)
+{
+    clearKey();
+    rsa_buf = reinterpret_cast<uint8_t *>(mem.alloc(size, true, mem_alloc_cache));
+    if (rsa_buf)
+        rsa_buf_size = size;
+    return rsa_buf != nullptr;
+}
+
+void JWTClass::mapKey(uint32_t n_bitlen, const size_t *len)
+{
+    // Point the key components to the key buffer.
+    unsigned char **comp[5] = {&rsa_key.p, &rsa_key.q, &rsa_key.dp, &rsa_key.dq, &rsa_key.iq};
+    size_t *comp_len[5] = {&rsa_key.plen, &rsa_key.qlen, &rsa_key.dplen, &rsa_key.dqlen, &rsa_key.iqlen};
+    uint8_t *p = rsa_buf;
+    rsa_key.n_bitlen = n_bitlen;
+    for (int i = 0; i < 5; i++)
+    {
+        *comp[i] = p;
+        *comp_len[i] = len[i];
+        p += len[i];
+    }
+}
+
+bool JWTClass::loadKey()
+{
+#if !defined(USE_LEGACY_TOKEN_ONLY) && !defined(FIREBASE_USE_LEGACY_TOKEN_ONLY)
+    const char *pem = jwt_data.pk.length() > 0 ? jwt_data.pk.c_str() : auth_data->user_auth.sa.val[sa_ns::pk].c_str();
+    uint32_t id = keyId(pem);
+
+    // The key was already decoded.
+    if (rsa_buf && rsa_key_id == id)
+        return true;
+
+#if defined(ENABLE_FS)
+    if (readKeyFile(id))
+        return true;
+#endif
+
+    // RSA private key
+    PrivateKey *pk = nullptr;
+    sys_idle();
+    // parse priv key
+    if (strlen(pem) > 0)
+        pk = new PrivateKey(pem);
+
+    jwt_data.pk.remove(0, jwt_data.pk.length());
+
+    if (!pk)
+    {
+        jwt_data.err_code = FIREBASE_ERROR_TOKEN_PARSE_PK;
+        jwt_data.msg = (const char *)FPSTR("JWT, private key parsing fail");
+        return false;
+    }
+
+    if (!pk->isRSA())
+    {
         delete pk;
         pk = nullptr;
+        jwt_data.err_code = FIREBASE_ERROR_TOKEN_PARSE_PK;
+        jwt_data.msg = (const char *)FPSTR("JWT, invalid RSA private key");
+        return false;
+    }
+
+    // Copy the key components to one buffer.
+    const br_rsa_private_key *k = pk->getRSA();
+    size_t len[5] = {k->plen, k->qlen, k->dplen, k->dqlen, k->iqlen};
+    bool ret = allocKey(len[0] + len[1] + len[2] + len[3] + len[4]);
+    if (ret)
+    {
+        mapKey(k->n_bitlen, len);
+        memcpy(rsa_key.p, k->p, k->plen);
+        memcpy(rsa_key.q, k->q, k->qlen);
+        memcpy(rsa_key.dp, k->dp, k->dplen);
+        memcpy(rsa_key.dq, k->dq, k->dqlen);
+        memcpy(rsa_key.iq, k->iq, k->iqlen);
+        rsa_key_id = id;
+    }
+
+    delete pk;
+    pk = nullptr;
+
+    if (!ret)
+    {
+        jwt_data.err_code = FIREBASE_ERROR_TOKEN_PARSE_PK;
+        jwt_data.msg = (const char *)FPSTR("JWT, private key parsing fail");
+        return false;
+    }
+
+#if defined(ENABLE_FS)
+    writeKeyFile();
+#endif
+    return true;
+#else
+    return false;
+#endif
+}
+
+void JWTClass::clearKey()
+{
+    // Wipe the key before releasing the memory.
+    if (rsa_buf)
+    {
+        volatile uint8_t *p = rsa_buf;
+        for (size_t i = 0; i < rsa_buf_size; i++)
+            p[i] = 0;
+        mem.release(&rsa_buf);
+    }
+    memset(&rsa_key, 0, sizeof(rsa_key));
+    rsa_buf_size = 0;
+    rsa_key_id = 0;
+}
+
+#if defined(ENABLE_FS)
+void JWTClass::setKeyCache(file_config_data &file) { key_file = &file; }
+
+// The key cache file contains the 'FRK' magic and version bytes, the PEM key hash, the modulus bit length,
+// the lengths of p, q, dp, dq and iq (2 bytes each) and the key components.
+#define FIREBASE_KEY_FILE_VERSION 2
+#define FIREBASE_KEY_FILE_HEADER_SIZE (12 + 5 * 2)
+
+bool JWTClass::readKeyFile(uint32_t id)
+{
+    if (!key_file || !key_file->initialized || !key_file->cb)
+        return false;
+
+    key_file->cb(key_file->file, key_file->filename.c_str(), file_mode_open_read);
+    if (!key_file->file)
+        return false;
 
-        // get the signed JWT
-        if (ret > 0)
+    uint8_t hdr[FIREBASE_KEY_FILE_HEADER_SIZE];
+    bool ret = false;
+    if ((size_t)key_file->file.read(hdr, sizeof(hdr)) == sizeof(hdr) && hdr[0] == 'F' && hdr[1] == 'R' && hdr[2] == 'K' && hdr[3] == FIREBASE_KEY_FILE_VERSION &&
+        (uint32_t)(hdr[4] | hdr[5] << 8 | hdr[6] << 16 | (uint32_t)hdr[7] << 24) == id)
+    {
+        size_t len[5], size = 0;
+        for (int i = 0; i < 5; i++)
         {
-            jwt_data.token += buf;
-            mem.release(&buf);
-            auth_data->user_auth.sa.step = jwt_step_ready;
+            len[i] = hdr[12 + i * 2] | hdr[13 + i * 2] << 8;
+            size += len[i];
         }
-        else
+
+        if (size > 0 && allocKey(size) && (size_t)key_file->file.read(rsa_buf, size) == size)
         {
-            mem.release(&buf);
-            jwt_data.err_code = FIREBASE_ERROR_TOKEN_SIGN;
-            jwt_data.msg = (const char *)FPSTR("JWT, token signing fail");
-            auth_data->user_auth.sa.step = jwt_step_error;
-            return exit(false);
+            mapKey(hdr[8] | hdr[9] << 8 | hdr[10] << 16 | (uint32_t)hdr[11] << 24, len);
+            rsa_key_id = id;
+            ret = true;
         }
+        else
+            clearKey();
     }
+    key_file->file.close();
+    return ret;
+}
 
+void JWTClass::writeKeyFile()
+{
+    if (!key_file || !key_file->initialized || !key_file->cb || !rsa_buf)
+        return;
+
+    key_file->cb(key_file->file, key_file->filename.c_str(), file_mode_open_write);
+    if (!key_file->file)
+        return;
+
+    uint8_t hdr[FIREBASE_KEY_FILE_HEADER_SIZE] = {'F', 'R', 'K', FIREBASE_KEY_FILE_VERSION};
+    uint32_t v[2] = {rsa_key_id, rsa_key.n_bitlen};
+    for (int i = 0; i < 8; i++)
+        hdr[4 + i] = v[i / 4] >> ((i % 4) * 8);
+    size_t len[5] = {rsa_key.plen, rsa_key.qlen, rsa_key.dplen, rsa_key.dqlen, rsa_key.iqlen};
+    for (int i = 0; i < 5; i++)
+    {
+        hdr[12 + i * 2] = len[i];
+        hdr[13 + i * 2] = len[i] >> 8;
+    }
+    key_file->file.write(hdr, sizeof(hdr));
+    key_file->file.write(rsa_buf, rsa_buf_size);
+    key_file->file.close();
+}
 #endif
 
-    return exit(true);
+bool JWTClass::signResult(bool ret)
+{
+    auth_data->user_auth.sa.step = ret ? jwt_step_ready : jwt_step_error;
+    return exit(ret);
+}
+
+bool JWTClass::pending()
+{
+#if defined(FIREBASE_JWT_WORKER)
+    return worker_state != jwt_worker_idle;
+#else
+    return false;
+#endif
+}
+
+#if defined(FIREBASE_JWT_WORKER)
+void JWTClass::workerTask(void *arg)
+{
+    JWTClass *jwt = reinterpret_cast<JWTClass *>(arg);
+    jwt->worker_ret = jwt->sign();
+    jwt->worker_state = jwt_worker_done;
+#if defined(FIREBASE_JWT_WORKER_RTOS)
+    vTaskDelete(NULL);
+#endif
+}
+
+bool JWTClass::startWorker()
+{
+    worker_state = jwt_worker_running;
+#if defined(FIREBASE_JWT_WORKER_RTOS)
+    if (xTaskCreate(workerTask, "jwtWorker", FIREBASE_JWT_WORKER_STACK_SIZE, this, 1, NULL) == pdPASS)
+        return true;
+#elif defined(FIREBASE_JWT_WORKER_THREAD)
+    worker = std::thread(workerTask, this);
+    return true;
+#endif
+    // Sign in the caller's task instead.
+    worker_state = jwt_worker_idle;
+    return false;
+}
+
+void JWTClass::waitWorker()
+{
+#if defined(FIREBASE_JWT_WORKER_RTOS)
+    while (worker_state == jwt_worker_running)
+        vTaskDelay(1);
+#elif defined(FIREBASE_JWT_WORKER_THREAD)
+    if (worker.joinable())
+        worker.join();
+#endif
+    if (worker_state == jwt_worker_done && jwt_data.signature)
+        mem.release(&jwt_data.signature);
+    worker_state = jwt_worker_idle;
 }
+#endif
 
 #endif
 
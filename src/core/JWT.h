@@ -38,6 +38,27 @@
 
 #if defined(ENABLE_JWT)
 
+#if defined(ENABLE_JWT_WORKER)
+#if defined(ESP32)
+#define FIREBASE_JWT_WORKER_RTOS
+#elif defined(__linux__) && __has_include(<thread>)
+#define FIREBASE_JWT_WORKER_THREAD
+#endif
+#endif
+
+#if defined(FIREBASE_JWT_WORKER_RTOS) || defined(FIREBASE_JWT_WORKER_THREAD)
+#define FIREBASE_JWT_WORKER
+#include <atomic>
+#if defined(FIREBASE_JWT_WORKER_THREAD)
+#include <thread>
+#endif
+#endif
+
+// The stack size in bytes of the JWT signing task.
+#if !defined(FIREBASE_JWT_WORKER_STACK_SIZE)
+#define FIREBASE_JWT_WORKER_STACK_SIZE 8192
+#endif
+
 #if __has_include(<ESP_SSLClient.h>)
 #include <ESP_SSLClient.h>
 #else
@@ -84,6 +105,40 @@ namespace firebase
         auth_data_t *auth_data = nullptr;
         bool processing = false;
 
+        // The decoded RSA private key that is reused for signing.
+        br_rsa_private_key rsa_key;
+        uint8_t *rsa_buf = nullptr;
+        size_t rsa_buf_size = 0;
+        uint32_t rsa_key_id = 0;
+#if defined(ENABLE_FS)
+        file_config_data *key_file = nullptr;
+        bool readKeyFile(uint32_t id);
+        void writeKeyFile();
+#endif
+        uint32_t keyId(const char *pem);
+        bool allocKey(size_t size);
+        void mapKey(uint32_t n_bitlen, const size_t *len);
+        bool loadKey();
+        void clearKey();
+
+#if defined(FIREBASE_JWT_WORKER)
+        enum jwt_worker_state
+        {
+            jwt_worker_idle,
+            jwt_worker_running,
+            jwt_worker_done
+        };
+
+        std::atomic<int> worker_state{jwt_worker_idle};
+        bool worker_ret = false;
+#if defined(FIREBASE_JWT_WORKER_THREAD)
+        std::thread worker;
+#endif
+        static void workerTask(void *arg);
+        bool startWorker();
+        void waitWorker();
+#endif
+
         bool exit(bool ret)
         {
             processing = false;
@@ -96,6 +151,10 @@ namespace firebase
 
         bool begin(auth_data_t *auth_data);
         bool create();
+        bool sign();
+        bool signResult(bool ret);
+        bool pending();
+        bool presign(auth_data_t *auth_data);
         void sendErrCB(AsyncResultCallback cb, AsyncResult *aResult= nullptr);
 
     public:
@@ -105,6 +164,9 @@ namespace firebase
         bool ready();
         void clear();
         bool loop(auth_data_t *auth_data);
+#if defined(ENABLE_FS)
+        void setKeyCache(file_config_data &file);
+#endif
     };
 
 }
@@ -36,11 +36,202 @@
 #endif
 #endif
 
+#if defined(ESP32) && defined(BOARD_HAS_PSRAM) && defined(FIREBASE_USE_PSRAM)
+#include <esp_heap_caps.h>
+#define FIREBASE_PSRAM_PLACEMENT
+#endif
+
+// The minimum size in bytes of the mem_alloc_auto allocation to be placed in PSRAM.
+#if !defined(FIREBASE_PSRAM_MIN_SIZE)
+#define FIREBASE_PSRAM_MIN_SIZE 1024
+#endif
+
+// The allocation class hint that decides where the memory is placed when PSRAM is available.
+enum mem_alloc_class
+{
+    mem_alloc_auto,    // Placed in PSRAM when its size is FIREBASE_PSRAM_MIN_SIZE or larger.
+    mem_alloc_scratch, // Small, hot and short-lived buffer, placed in internal RAM.
+    mem_alloc_chunk,   // I/O chunk buffer, placed in internal RAM.
+    mem_alloc_bulk,    // Large payload data, placed in PSRAM.
+    mem_alloc_cache    // Long-lived data, placed in PSRAM.
+};
+
+#if defined(FIREBASE_MEMORY_STATS)
+
+// The counters are updated from the JWT worker and, with the malloc interposer (MemoryInterpose.h), from any thread.
+#if defined(ENABLE_JWT_WORKER) || defined(FIREBASE_MEMORY_STATS_INTERPOSE)
+#define FIREBASE_MEMORY_STATS_ATOMIC
+#include <atomic>
+#endif
+
+// The operation types that the allocations are counted for.
+enum mem_op_type
+{
+    mem_op_other,
+    mem_op_set,
+    mem_op_get,
+    mem_op_sse_event,
+    mem_op_upload_chunk,
+    mem_op_download_chunk,
+    mem_op_max_type
+};
+
+struct mem_stats_t
+{
+    uint32_t count = 0;
+    size_t bytes = 0;
+};
+
+#if defined(FIREBASE_MEMORY_STATS_ATOMIC)
+typedef std::atomic<size_t> mem_counter_t;
+#else
+typedef size_t mem_counter_t;
+#endif
+
+// The allocation counters of each operation type and the heap bytes in use and its peak.
+// Only the library allocations (Memory) are counted unless the malloc interposer (MemoryInterpose.h) is used,
+// which also counts String and other allocations.
+// The operation type is kept per thread when the counters are atomic, the allocations of the JWT worker are counted as other.
+class MemoryStats
+{
+private:
+    struct counters_t
+    {
+        mem_counter_t count[mem_op_max_type];
+        mem_counter_t bytes[mem_op_max_type];
+        mem_counter_t in_use;
+        mem_counter_t peak;
+    };
+
+    // The counters are zero-initialized static data, they are ready before any allocation.
+    static counters_t &counters()
+    {
+        static counters_t c;
+        return c;
+    }
+    static mem_op_type &currentOp()
+    {
+#if defined(FIREBASE_MEMORY_STATS_ATOMIC)
+        static thread_local mem_op_type op = mem_op_other;
+#else
+        static mem_op_type op = mem_op_other;
+#endif
+        return op;
+    }
+
+public:
+    // Count the allocations as the operation type until it goes out of scope.
+    class Scope
+    {
+    private:
+        mem_op_type prev;
+
+    public:
+        explicit Scope(mem_op_type type) : prev(currentOp()) { currentOp() = type; }
+        ~Scope() { currentOp() = prev; }
+    };
+
+    static void add(size_t len)
+    {
+        counters_t &c = counters();
+        mem_op_type op = currentOp();
+        c.count[op] += 1;
+        c.bytes[op] += len;
+        size_t used = (c.in_use += len);
+#if defined(FIREBASE_MEMORY_STATS_ATOMIC)
+        size_t peak = c.peak.load();
+        while (used > peak && !c.peak.compare_exchange_weak(peak, used))
+            ;
+#else
+        if (used > c.peak)
+            c.peak = used;
+#endif
+    }
+
+    static void remove(size_t len)
+    {
+        counters_t &c = counters();
+#if defined(FIREBASE_MEMORY_STATS_ATOMIC)
+        size_t used = c.in_use.load();
+        while (!c.in_use.compare_exchange_weak(used, used > len ? used - len : 0))
+            ;
+#else
+        c.in_use = c.in_use > len ? c.in_use - len : 0;
+#endif
+    }
+
+    static mem_stats_t get(mem_op_type type)
+    {
+        mem_op_type op = type < mem_op_max_type ? type : mem_op_other;
+        mem_stats_t s;
+        s.count = counters().count[op];
+        s.bytes = counters().bytes[op];
+        return s;
+    }
+
+    static size_t inUse() { return counters().in_use; }
+
+    static size_t peak() { return counters().peak; }
+
+    static void reset()
+    {
+        counters_t &c = counters();
+        for (size_t i = 0; i < mem_op_max_type; i++)
+        {
+            c.count[i] = 0;
+            c.bytes[i] = 0;
+        }
+        c.peak = static_cast<size_t>(c.in_use);
+    }
+};
+
+#define FIREBASE_MEM_STATS_SCOPE(type) MemoryStats::Scope mem_stats_scope(type)
+#endif
+
+// The size of allocation is kept in front of the buffer when Memory counts its own allocations,
+// the interposer counts them when it is used.
+#if defined(FIREBASE_MEMORY_STATS) && !defined(FIREBASE_MEMORY_STATS_INTERPOSE)
+#define FIREBASE_MEMORY_STATS_HEADER
+#define FIREBASE_MEM_HEADER_SIZE 8
+#else
+#define FIREBASE_MEM_HEADER_SIZE 0
+#endif
+
+#if !defined(FIREBASE_MEMORY_STATS)
+#define FIREBASE_MEM_STATS_SCOPE(type)
+#endif
+
 class Memory
 {
 private:
+#if defined(FIREBASE_PSRAM_PLACEMENT)
+    void *placeAlloc(size_t len, mem_alloc_class cls)
+    {
+        if (!psramFound())
+            return malloc(len);
+
+        bool ext = cls == mem_alloc_bulk || cls == mem_alloc_cache || (cls == mem_alloc_auto && len >= FIREBASE_PSRAM_MIN_SIZE);
+        void *p = ext ? ps_malloc(len) : heap_caps_malloc(len, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        // Use the other memory when the preferred one is exhausted.
+        if (!p)
+            p = ext ? heap_caps_malloc(len, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT) : ps_malloc(len);
+        return p;
+    }
+#endif
+
 public:
-    Memory() {}
+    Memory()
+    {
+#if defined(FIREBASE_PSRAM_PLACEMENT) && defined(FIREBASE_PSRAM_STRING_MIN_SIZE) && defined(CONFIG_SPIRAM_USE_MALLOC)
+        // The String buffers are allocated by malloc, let malloc place the large ones in PSRAM.
+        static bool extmem_enabled = false;
+        if (!extmem_enabled && psramFound())
+        {
+            heap_caps_malloc_extmem_enable(FIREBASE_PSRAM_STRING_MIN_SIZE);
+            extmem_enabled = true;
+        }
+#endif
+    }
     ~Memory() {}
 
     // Free reserved memory at pointer.
@@ -49,29 +240,30 @@ public:
         void **p = (void **)ptr;
         if (*p)
         {
+#if defined(FIREBASE_MEMORY_STATS_HEADER)
+            *p = (uint8_t *)*p - FIREBASE_MEM_HEADER_SIZE;
+            MemoryStats::remove(*(uint32_t *)*p);
+#endif
             free(*p);
             *p = 0;
         }
     }
 
-    void *alloc(size_t len, bool clear = true)
+    void *alloc(size_t len, bool clear = true, mem_alloc_class cls = mem_alloc_auto)
     {
         void *p;
         size_t newLen = getReservedLen(len);
-#if defined(BOARD_HAS_PSRAM)
-        if (ESP.getPsramSize() > 0)
-            p = (void *)ps_malloc(newLen);
-        else
-            p = (void *)malloc(newLen);
-
+#if defined(FIREBASE_PSRAM_PLACEMENT)
+        p = placeAlloc(newLen + FIREBASE_MEM_HEADER_SIZE, cls);
         if (!p)
             return NULL;
 #else
+        (void)cls;
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
         ESP.setExternalHeap();
 #endif
-        p = (void *)malloc(newLen);
+        p = (void *)malloc(newLen + FIREBASE_MEM_HEADER_SIZE);
         bool nn = p ? true : false;
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
         ESP.resetHeap();
@@ -80,6 +272,11 @@ public:
         if (!nn)
             return NULL;
 
+#endif
+#if defined(FIREBASE_MEMORY_STATS_HEADER)
+        *(uint32_t *)p = newLen;
+        MemoryStats::add(newLen);
+        p = (uint8_t *)p + FIREBASE_MEM_HEADER_SIZE;
 #endif
         if (clear)
             memset(p, 0, newLen);
@@ -96,4 +293,90 @@ public:
     }
 };
 
+#if !defined(FIREBASE_CHUNK_POOL_SIZE)
+#define FIREBASE_CHUNK_POOL_SIZE 2
+#endif
+
+// The fixed pool of I/O chunk buffers that are borrowed and returned per chunk.
+// The buffers are allocated on first use and are not zero-filled unless requested.
+class ChunkPool
+{
+private:
+    Memory mem;
+    uint8_t *bufs[FIREBASE_CHUNK_POOL_SIZE > 0 ? FIREBASE_CHUNK_POOL_SIZE : 1];
+    bool used[FIREBASE_CHUNK_POOL_SIZE > 0 ? FIREBASE_CHUNK_POOL_SIZE : 1];
+    size_t buf_size = 0;
+    uint32_t miss_count = 0;
+
+public:
+    explicit ChunkPool(size_t size) : buf_size(size)
+    {
+        for (size_t i = 0; i < FIREBASE_CHUNK_POOL_SIZE; i++)
+        {
+            bufs[i] = nullptr;
+            used[i] = false;
+        }
+    }
+
+    ~ChunkPool()
+    {
+        for (size_t i = 0; i < FIREBASE_CHUNK_POOL_SIZE; i++)
+            mem.release(&bufs[i]);
+    }
+
+    // Borrow the buffer of len bytes, the heap is used when len is larger than the pool buffer or all buffers are in use.
+    void *alloc(size_t len, bool clear = false)
+    {
+        if (len <= buf_size)
+        {
+            for (size_t i = 0; i < FIREBASE_CHUNK_POOL_SIZE; i++)
+            {
+                if (used[i])
+                    continue;
+                if (!bufs[i])
+                    bufs[i] = reinterpret_cast<uint8_t *>(mem.alloc(buf_size, false, mem_alloc_chunk));
+                if (!bufs[i])
+                    break;
+                used[i] = true;
+                if (clear)
+                    memset(bufs[i], 0, len);
+                return bufs[i];
+            }
+        }
+        miss_count++;
+        return mem.alloc(len, clear, mem_alloc_chunk);
+    }
+
+    // Return the buffer at pointer to the pool or free it if it was not taken from the pool.
+    void release(void *ptr)
+    {
+        void **p = (void **)ptr;
+        if (!*p)
+            return;
+        for (size_t i = 0; i < FIREBASE_CHUNK_POOL_SIZE; i++)
+        {
+            if (bufs[i] == *p)
+            {
+                used[i] = false;
+                *p = 0;
+                return;
+            }
+        }
+        mem.release(ptr);
+    }
+
+    // Free the pool buffers that are not in use.
+    void shrink()
+    {
+        for (size_t i = 0; i < FIREBASE_CHUNK_POOL_SIZE; i++)
+        {
+            if (!used[i])
+                mem.release(&bufs[i]);
+        }
+    }
+
+    // Get the number of buffers that were allocated from the heap instead of the pool.
+    uint32_t misses() const { return miss_count; }
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,150 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef CORE_MEMORY_INTERPOSE_H
+#define CORE_MEMORY_INTERPOSE_H
+
+#include <Arduino.h>
+#include "./Config.h"
+#include "./core/Memory.h"
+
+/**
+ * The malloc interposer that counts all heap allocations in MemoryStats, including the String buffers
+ * and operator new (which allocates with malloc) of the library and the application.
+ *
+ * It requires FIREBASE_MEMORY_STATS and FIREBASE_MEMORY_STATS_INTERPOSE to be defined in the build flags,
+ * and this header should be included in only one source file e.g. the sketch or test.
+ *
+ * On Linux (glibc), the malloc functions are replaced and forwarded to the glibc allocator.
+ * On ESP32, the malloc functions are wrapped by the linker with the build flags
+ * -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc -Wl,--wrap=free
+ *
+ * The realloc is counted as the new allocation.
+ */
+
+#if defined(FIREBASE_MEMORY_STATS) && defined(FIREBASE_MEMORY_STATS_INTERPOSE)
+
+#if defined(__GLIBC__)
+
+#include <malloc.h>
+
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t n, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void __libc_free(void *ptr);
+
+    void *malloc(size_t size)
+    {
+        void *p = __libc_malloc(size);
+        if (p)
+            MemoryStats::add(malloc_usable_size(p));
+        return p;
+    }
+
+    void *calloc(size_t n, size_t size)
+    {
+        void *p = __libc_calloc(n, size);
+        if (p)
+            MemoryStats::add(malloc_usable_size(p));
+        return p;
+    }
+
+    void *realloc(void *ptr, size_t size)
+    {
+        size_t old = ptr ? malloc_usable_size(ptr) : 0;
+        void *p = __libc_realloc(ptr, size);
+        if (p || size == 0)
+        {
+            MemoryStats::remove(old);
+            if (p)
+                MemoryStats::add(malloc_usable_size(p));
+        }
+        return p;
+    }
+
+    void free(void *ptr)
+    {
+        if (ptr)
+            MemoryStats::remove(malloc_usable_size(ptr));
+        __libc_free(ptr);
+    }
+}
+
+#elif defined(ESP32)
+
+#include <esp_heap_caps.h>
+
+extern "C"
+{
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t n, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+    void __real_free(void *ptr);
+
+    void *__wrap_malloc(size_t size)
+    {
+        void *p = __real_malloc(size);
+        if (p)
+            MemoryStats::add(heap_caps_get_allocated_size(p));
+        return p;
+    }
+
+    void *__wrap_calloc(size_t n, size_t size)
+    {
+        void *p = __real_calloc(n, size);
+        if (p)
+            MemoryStats::add(heap_caps_get_allocated_size(p));
+        return p;
+    }
+
+    void *__wrap_realloc(void *ptr, size_t size)
+    {
+        size_t old = ptr ? heap_caps_get_allocated_size(ptr) : 0;
+        void *p = __real_realloc(ptr, size);
+        if (p || size == 0)
+        {
+            MemoryStats::remove(old);
+            if (p)
+                MemoryStats::add(heap_caps_get_allocated_size(p));
+        }
+        return p;
+    }
+
+    void __wrap_free(void *ptr)
+    {
+        if (ptr)
+            MemoryStats::remove(heap_caps_get_allocated_size(ptr));
+        __real_free(ptr);
+    }
+}
+
+#else
+#error "The malloc interposer (FIREBASE_MEMORY_STATS_INTERPOSE) supports Linux (glibc) and ESP32 only."
+#endif
+
+#endif
+
+#endif
@@ -0,0 +1,517 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef CORE_NUMBER_FORMAT_H
+#define CORE_NUMBER_FORMAT_H
+
+#include <Arduino.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+#include "./Config.h"
+
+// The buffer size that fits any formatted number with its null terminator.
+#define FIREBASE_NUMBER_BUF_SIZE 40
+
+/**
+ * The number to text conversion without allocation.
+ *
+ * The integer is written with the two digits table. The floating point number is written with the fewest digits
+ * that read back to the same value (Grisu2, the shortest in nearly all cases), e.g. 0.1f is "0.1" and 1e21 is "1e+21",
+ * the integral value keeps its decimal point e.g. "3.0". The fixed decimal places format is also provided for number_t(value, decimals).
+ */
+class NumberFormat
+{
+public:
+    /**
+     * Write the number to the buffer.
+     * @param buf The buffer of at least FIREBASE_NUMBER_BUF_SIZE bytes.
+     * @param value The integer or floating point number.
+     * @return size_t The length of the null-terminated text.
+     */
+    template <typename T>
+    static auto format(char *buf, T value) -> typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, size_t>::type
+    {
+        if (value < 0)
+        {
+            buf[0] = '-';
+            // The negation in unsigned type that keeps the minimum value.
+            return 1 + format(buf + 1, static_cast<typename std::make_unsigned<T>::type>(0 - static_cast<typename std::make_unsigned<T>::type>(value)));
+        }
+        return format(buf, static_cast<typename std::make_unsigned<T>::type>(value));
+    }
+
+    template <typename T>
+    static auto format(char *buf, T value) -> typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, size_t>::type
+    {
+        // The 64-bit division is avoided for the value that fits in 32 bits.
+        if (sizeof(T) > 4 && value > 0xffffffffULL)
+            return formatU64(buf, value);
+        return formatU32(buf, static_cast<uint32_t>(value));
+    }
+
+    template <typename T>
+    static auto format(char *buf, T value) -> typename std::enable_if<std::is_floating_point<T>::value, size_t>::type
+    {
+        char *p = buf;
+        if (isnan(value) || isinf(value))
+            return special(buf, value);
+
+        if (signbit(value))
+        {
+            *p++ = '-';
+            value = -value;
+        }
+
+        if (value == 0)
+        {
+            memcpy(p, "0.0", 4);
+            return p + 3 - buf;
+        }
+
+        int len = 0, exp = 0;
+        grisu2(p, len, exp, value);
+        p = formatDigits(p, len, exp);
+        *p = 0;
+        return p - buf;
+    }
+
+    // Set the String to the number.
+    template <typename T>
+    static void toString(String &str, T value)
+    {
+        char buf[FIREBASE_NUMBER_BUF_SIZE];
+        format(buf, value);
+        str = buf;
+    }
+
+    static void toString(String &str, double value, int decimals)
+    {
+        char buf[FIREBASE_NUMBER_BUF_SIZE];
+        format(buf, value, decimals);
+        str = buf;
+    }
+
+    /**
+     * Write the floating point number with fixed decimal places, the value is rounded half away from zero.
+     * The value that is too large for fixed notation is written in the shortest form.
+     * @param buf The buffer of at least FIREBASE_NUMBER_BUF_SIZE bytes.
+     * @param value The floating point number.
+     * @param decimals The number of decimal places (0 to 15).
+     * @return size_t The length of the null-terminated text.
+     */
+    static size_t format(char *buf, double value, int decimals)
+    {
+        if (isnan(value) || isinf(value))
+            return special(buf, value);
+
+        double v = value < 0 ? -value : value;
+        if (decimals < 0)
+            decimals = 0;
+        if (v >= 1e15 || decimals > 15)
+            return format(buf, value);
+
+        uint64_t scale = pow10u64(decimals), ip = static_cast<uint64_t>(v);
+        uint64_t frac = static_cast<uint64_t>((v - ip) * scale + 0.5);
+        if (frac >= scale)
+        {
+            ip++;
+            frac -= scale;
+        }
+
+        char *p = buf;
+        if (value < 0)
+            *p++ = '-';
+        p += format(p, ip);
+        if (decimals > 0)
+        {
+            *p++ = '.';
+            char *end = p + decimals;
+            for (char *d = end - 1; d >= p; d--)
+            {
+                *d = '0' + frac % 10;
+                frac /= 10;
+            }
+            p = end;
+        }
+        *p = 0;
+        return p - buf;
+    }
+
+private:
+    struct diy_fp_t
+    {
+        uint64_t f;
+        int e;
+    };
+
+    struct cached_power_t
+    {
+        uint64_t f;
+        int16_t e;
+        int16_t k;
+    };
+
+    static size_t special(char *buf, double value)
+    {
+        const char *s = isnan(value) ? "nan" : (value < 0 ? "-inf" : "inf");
+        size_t len = strlen(s);
+        memcpy(buf, s, len + 1);
+        return len;
+    }
+
+    static uint64_t pow10u64(int n)
+    {
+        uint64_t v = 1;
+        while (n-- > 0)
+            v *= 10;
+        return v;
+    }
+
+    static void putDigits2(char *p, uint32_t v)
+    {
+        static const char digits2[201] PROGMEM = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                                 "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                                 "8081828384858687888990919293949596979899";
+        memcpy_P(p, digits2 + v * 2, 2);
+    }
+
+    static size_t formatU32(char *buf, uint32_t value)
+    {
+        // The digits are written backward from the end of the temporary buffer in pairs.
+        char tmp[10];
+        char *p = tmp + sizeof(tmp);
+        while (value >= 100)
+        {
+            p -= 2;
+            putDigits2(p, value % 100);
+            value /= 100;
+        }
+        if (value >= 10)
+        {
+            p -= 2;
+            putDigits2(p, value);
+        }
+        else
+            *--p = '0' + value;
+
+        size_t len = tmp + sizeof(tmp) - p;
+        memcpy(buf, p, len);
+        buf[len] = 0;
+        return len;
+    }
+
+    static size_t formatU64(char *buf, uint64_t value)
+    {
+        // The value is split into 9-digit parts to use the 32-bit conversion.
+        uint32_t parts[3];
+        int n = 0;
+        while (value > 0xffffffffULL)
+        {
+            parts[n++] = static_cast<uint32_t>(value % 1000000000);
+            value /= 1000000000;
+        }
+        size_t len = formatU32(buf, static_cast<uint32_t>(value));
+        while (n > 0)
+        {
+            char *p = buf + len + 9;
+            uint32_t v = parts[--n];
+            for (int i = 0; i < 4; i++)
+            {
+                p -= 2;
+                putDigits2(p, v % 100);
+                v /= 100;
+            }
+            *--p = '0' + v;
+            len += 9;
+        }
+        buf[len] = 0;
+        return len;
+    }
+
+    static diy_fp_t sub(const diy_fp_t &x, const diy_fp_t &y) { return {x.f - y.f, x.e}; }
+
+    static diy_fp_t mul(const diy_fp_t &x, const diy_fp_t &y)
+    {
+        // The upper 64 bits of the 128-bit product, rounded.
+        const uint64_t u_lo = x.f & 0xffffffffu, u_hi = x.f >> 32, v_lo = y.f & 0xffffffffu, v_hi = y.f >> 32;
+        const uint64_t p0 = u_lo * v_lo, p1 = u_lo * v_hi, p2 = u_hi * v_lo, p3 = u_hi * v_hi;
+        uint64_t q = (p0 >> 32) + (p1 & 0xffffffffu) + (p2 & 0xffffffffu);
+        q += uint64_t{1} << 31;
+        return {p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32), x.e + y.e + 64};
+    }
+
+    static diy_fp_t normalize(diy_fp_t x)
+    {
+        while ((x.f >> 63) == 0)
+        {
+            x.f <<= 1;
+            x.e--;
+        }
+        return x;
+    }
+
+    // Get the value and its boundaries, the boundaries are of the type T precision.
+    template <typename T>
+    static void boundaries(T value, diy_fp_t &w, diy_fp_t &m_minus, diy_fp_t &m_plus)
+    {
+        const int precision = std::is_same<T, float>::value ? 24 : 53;
+        const int bias = (std::is_same<T, float>::value ? 127 : 1023) + precision - 1;
+        const uint64_t hidden = uint64_t{1} << (precision - 1);
+
+        uint64_t bits = 0;
+        if (std::is_same<T, float>::value)
+        {
+            uint32_t b32;
+            float f = static_cast<float>(value);
+            memcpy(&b32, &f, sizeof(b32));
+            bits = b32;
+        }
+        else
+        {
+            double d = static_cast<double>(value);
+            memcpy(&bits, &d, sizeof(bits));
+        }
+
+        const uint64_t E = bits >> (precision - 1), F = bits & (hidden - 1);
+        const diy_fp_t v = E == 0 ? diy_fp_t{F, 1 - bias} : diy_fp_t{F + hidden, static_cast<int>(E) - bias};
+
+        // The lower boundary is closer when the significand is the power of two.
+        m_plus = normalize({2 * v.f + 1, v.e - 1});
+        diy_fp_t lower = F == 0 && E > 1 ? diy_fp_t{4 * v.f - 1, v.e - 2} : diy_fp_t{2 * v.f - 1, v.e - 1};
+        lower.f <<= lower.e - m_plus.e;
+        lower.e = m_plus.e;
+        m_minus = lower;
+        w = normalize(v);
+    }
+
+    // Get the cached power of ten c = f * 2^e ~= 10^k that brings the binary exponent into [-60, -32].
+    static cached_power_t cachedPower(int e)
+    {
+        static const cached_power_t powers[79] PROGMEM = {
+        {0xAB70FE17C79AC6CA, -1060, -300},
+        {0xFF77B1FCBEBCDC4F, -1034, -292},
+        {0xBE5691EF416BD60C, -1007, -284},
+        {0x8DD01FAD907FFC3C, -980, -276},
+        {0xD3515C2831559A83, -954, -268},
+        {0x9D71AC8FADA6C9B5, -927, -260},
+        {0xEA9C227723EE8BCB, -901, -252},
+        {0xAECC49914078536D, -874, -244},
+        {0x823C12795DB6CE57, -847, -236},
+        {0xC21094364DFB5637, -821, -228},
+        {0x9096EA6F3848984F, -794, -220},
+        {0xD77485CB25823AC7, -768, -212},
+        {0xA086CFCD97BF97F4, -741, -204},
+        {0xEF340A98172AACE5, -715, -196},
+        {0xB23867FB2A35B28E, -688, -188},
+        {0x84C8D4DFD2C63F3B, -661, -180},
+        {0xC5DD44271AD3CDBA, -635, -172},
+        {0x936B9FCEBB25C996, -608, -164},
+        {0xDBAC6C247D62A584, -582, -156},
+        {0xA3AB66580D5FDAF6, -555, -148},
+        {0xF3E2F893DEC3F126, -529, -140},
+        {0xB5B5ADA8AAFF80B8, -502, -132},
+        {0x87625F056C7C4A8B, -475, -124},
+        {0xC9BCFF6034C13053, -449, -116},
+        {0x964E858C91BA2655, -422, -108},
+        {0xDFF9772470297EBD, -396, -100},
+        {0xA6DFBD9FB8E5B88F, -369, -92},
+        {0xF8A95FCF88747D94, -343, -84},
+        {0xB94470938FA89BCF, -316, -76},
+        {0x8A08F0F8BF0F156B, -289, -68},
+        {0xCDB02555653131B6, -263, -60},
+        {0x993FE2C6D07B7FAC, -236, -52},
+        {0xE45C10C42A2B3B06, -210, -44},
+        {0xAA242499697392D3, -183, -36},
+        {0xFD87B5F28300CA0E, -157, -28},
+        {0xBCE5086492111AEB, -130, -20},
+        {0x8CBCCC096F5088CC, -103, -12},
+        {0xD1B71758E219652C, -77, -4},
+        {0x9C40000000000000, -50, 4},
+        {0xE8D4A51000000000, -24, 12},
+        {0xAD78EBC5AC620000, 3, 20},
+        {0x813F3978F8940984, 30, 28},
+        {0xC097CE7BC90715B3, 56, 36},
+        {0x8F7E32CE7BEA5C70, 83, 44},
+        {0xD5D238A4ABE98068, 109, 52},
+        {0x9F4F2726179A2245, 136, 60},
+        {0xED63A231D4C4FB27, 162, 68},
+        {0xB0DE65388CC8ADA8, 189, 76},
+        {0x83C7088E1AAB65DB, 216, 84},
+        {0xC45D1DF942711D9A, 242, 92},
+        {0x924D692CA61BE758, 269, 100},
+        {0xDA01EE641A708DEA, 295, 108},
+        {0xA26DA3999AEF774A, 322, 116},
+        {0xF209787BB47D6B85, 348, 124},
+        {0xB454E4A179DD1877, 375, 132},
+        {0x865B86925B9BC5C2, 402, 140},
+        {0xC83553C5C8965D3D, 428, 148},
+        {0x952AB45CFA97A0B3, 455, 156},
+        {0xDE469FBD99A05FE3, 481, 164},
+        {0xA59BC234DB398C25, 508, 172},
+        {0xF6C69A72A3989F5C, 534, 180},
+        {0xB7DCBF5354E9BECE, 561, 188},
+        {0x88FCF317F22241E2, 588, 196},
+        {0xCC20CE9BD35C78A5, 614, 204},
+        {0x98165AF37B2153DF, 641, 212},
+        {0xE2A0B5DC971F303A, 667, 220},
+        {0xA8D9D1535CE3B396, 694, 228},
+        {0xFB9B7CD9A4A7443C, 720, 236},
+        {0xBB764C4CA7A44410, 747, 244},
+        {0x8BAB8EEFB6409C1A, 774, 252},
+        {0xD01FEF10A657842C, 800, 260},
+        {0x9B10A4E5E9913129, 827, 268},
+        {0xE7109BFBA19C0C9D, 853, 276},
+        {0xAC2820D9623BF429, 880, 284},
+        {0x80444B5E7AA7CF85, 907, 292},
+        {0xBF21E44003ACDD2D, 933, 300},
+        {0x8E679C2F5E44FF8F, 960, 308},
+        {0xD433179D9C8CB841, 986, 316},
+        {0x9E19DB92B4E31BA9, 1013, 324},
+        };
+        const int f = -60 - e - 1;
+        const int k = (f * 78913L) / (1L << 18) + (f > 0);
+        const int index = (300 + k + 7) / 8;
+        cached_power_t c;
+        memcpy_P(&c, &powers[index], sizeof(c));
+        return c;
+    }
+
+    static int largestPow10(uint32_t n, uint32_t &pow10)
+    {
+        static const uint32_t p[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+        int digits = 10;
+        while (digits > 1 && n < p[digits - 1])
+            digits--;
+        pow10 = p[digits - 1];
+        return digits;
+    }
+
+    static void roundDigit(char *buf, int len, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
+    {
+        // Move the last digit closer to the exact value while it is still in the rounding interval.
+        while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+        {
+            buf[len - 1]--;
+            rest += ten_k;
+        }
+    }
+
+    static void digitGen(char *buf, int &len, int &exp, diy_fp_t m_minus, diy_fp_t w, diy_fp_t m_plus)
+    {
+        uint64_t delta = sub(m_plus, m_minus).f, dist = sub(m_plus, w).f;
+        const diy_fp_t one = {uint64_t{1} << -m_plus.e, m_plus.e};
+        uint32_t p1 = static_cast<uint32_t>(m_plus.f >> -one.e);
+        uint64_t p2 = m_plus.f & (one.f - 1);
+
+        uint32_t pow10 = 0;
+        int n = largestPow10(p1, pow10);
+        while (n > 0)
+        {
+            buf[len++] = '0' + p1 / pow10;
+            p1 %= pow10;
+            n--;
+            const uint64_t rest = (uint64_t{p1} << -one.e) + p2;
+            if (rest <= delta)
+            {
+                exp += n;
+                roundDigit(buf, len, dist, delta, rest, uint64_t{pow10} << -one.e);
+                return;
+            }
+            pow10 /= 10;
+        }
+
+        int m = 0;
+        for (;;)
+        {
+            p2 *= 10;
+            buf[len++] = '0' + static_cast<char>(p2 >> -one.e);
+            p2 &= one.f - 1;
+            m++;
+            delta *= 10;
+            dist *= 10;
+            if (p2 <= delta)
+                break;
+        }
+        exp -= m;
+        roundDigit(buf, len, dist, delta, p2, one.f);
+    }
+
+    template <typename T>
+    static void grisu2(char *buf, int &len, int &exp, T value)
+    {
+        diy_fp_t w, m_minus, m_plus;
+        boundaries(value, w, m_minus, m_plus);
+        const cached_power_t c = cachedPower(m_plus.e);
+        const diy_fp_t c_minus_k = {c.f, c.e};
+        const diy_fp_t w_minus = mul(m_minus, c_minus_k), w_plus = mul(m_plus, c_minus_k);
+        exp = -c.k;
+        digitGen(buf, len, exp, {w_minus.f + 1, w_minus.e}, mul(w, c_minus_k), {w_plus.f - 1, w_plus.e});
+    }
+
+    // Write the digits d1d2..dn * 10^exp in decimal notation or in exponent notation when it is too small or large.
+    static char *formatDigits(char *buf, int k, int exp)
+    {
+        const int n = k + exp;
+        if (k <= n && n <= 15)
+        {
+            memset(buf + k, '0', n - k);
+            buf[n] = '.';
+            buf[n + 1] = '0';
+            return buf + n + 2;
+        }
+
+        if (0 < n && n <= 15)
+        {
+            memmove(buf + n + 1, buf + n, k - n);
+            buf[n] = '.';
+            return buf + k + 1;
+        }
+
+        if (-4 < n && n <= 0)
+        {
+            memmove(buf + 2 - n, buf, k);
+            buf[0] = '0';
+            buf[1] = '.';
+            memset(buf + 2, '0', -n);
+            return buf + 2 - n + k;
+        }
+
+        if (k > 1)
+        {
+            memmove(buf + 2, buf + 1, k - 1);
+            buf[1] = '.';
+            buf += k + 1;
+        }
+        else
+            buf++;
+
+        *buf++ = 'e';
+        int e = n - 1;
+        *buf++ = e < 0 ? '-' : '+';
+        return buf + formatU32(buf, e < 0 ? -e : e);
+    }
+};
+
+#endif
@@ -36,46 +36,20 @@
 class OTAUtil
 {
 public:
-    void getPad(uint8_t *s, int &len, int8_t &pad)
-    {
-        pad = -1;
-        if (len > 1)
-        {
-            if (s[len - 1] == '"')
-            {
-                pad = 0;
-                if (len > 2)
-                {
-                    if (s[len - 2] == '=')
-                        pad++;
-                }
-                if (len > 3)
-                {
-                    if (s[len - 3] == '=')
-                        pad++;
-                }
-                s[len - 1] = 0;
-                len--;
-            }
-        }
-    }
-
-    bool decodeBase64OTA(Memory &mem, Base64Util *but, const char *src, size_t len, int16_t &code)
+    bool decodeBase64OTA(Memory &mem, Base64Util *but, Base64Decoder &dec, const char *src, size_t len, bool last, int16_t &code)
     {
 
         bool ret = true;
         firebase_base64_io_t<uint8_t> out;
-        uint8_t *buf = reinterpret_cast<uint8_t *>(mem.alloc(out.bufLen));
+        uint8_t *buf = reinterpret_cast<uint8_t *>(mem.alloc(out.bufLen, false, mem_alloc_chunk));
         out.ota = true;
         out.outT = buf;
-        unsigned char *base64DecBuf = but->creatBase64DecBuffer(mem);
-        if (!but->decode<uint8_t>(mem, base64DecBuf, src, strlen(src), out))
+        if (!but->decode(dec, src, len, out, last))
         {
             code = FIREBASE_ERROR_FW_UPDATE_WRITE_FAILED;
             ret = false;
         }
         mem.release(&buf);
-        mem.release(&base64DecBuf);
         return ret;
     }
 
@@ -29,6 +29,7 @@
 #include "./Config.h"
 
 #include "./core/JSON.h"
+#include "./core/NumberFormat.h"
 
 #define RESOURCE_PATH_BASE FPSTR("<resource_path>")
 
@@ -67,6 +68,50 @@ public:
         buf = str;
     }
 
+    // Grow the buffer capacity geometrically, the capacity is tracked by the caller
+    // because String::reserve reallocates to the exact size.
+    void reserve(String &buf, size_t &cap, size_t len)
+    {
+        if (len > cap)
+        {
+            cap = len > cap * 2 ? len : cap * 2;
+            buf.reserve(cap);
+        }
+    }
+
+    // Append the key/value pair in place of the closing token at the end of the object buffer.
+    void appendPair(String &buf, size_t &cap, const String &key, const String &value, const String &token)
+    {
+        if (key.length() == 0)
+            return;
+        reserve(buf, cap, buf.length() + key.length() + value.length() + 4);
+        buf.remove(buf.length() - token.length());
+        jut.addObject(buf, key, value, false);
+        buf += token;
+    }
+
+    // Append the value in place of the closing token at the end of the array buffer.
+    void appendValue(String &buf, size_t &cap, const String &value, const String &token)
+    {
+        reserve(buf, cap, buf.length() + value.length() + 1);
+        buf.remove(buf.length() - token.length());
+        buf += ',';
+        buf += value;
+        buf += token;
+    }
+
+    size_t printPair(Print &p, const char *key, const String &value) const
+    {
+        if (value.length() == 0)
+            return 0;
+        size_t n = p.print(FPSTR("{\""));
+        n += p.print(key);
+        n += p.print(FPSTR("\":"));
+        n += p.print(value.c_str());
+        n += p.print('}');
+        return n;
+    }
+
     void addObject(String &buf, const String &object, const String &token, bool clear = false)
     {
         if (clear)
@@ -80,43 +125,93 @@ public:
         }
     }
 
-    void addMapArrayMember(String *buf, size_t size, uint8_t index, const String &key, const String &memberValue, bool isString)
+    // Add the value, the string value is quoted unless it was already quoted.
+    void addValue(String &buf, const char *value, bool isString)
+    {
+        size_t len = strlen(value);
+        if (isString && value[0] != '"')
+            buf += '"';
+        buf += value;
+        if (isString && (len == 0 || value[len - 1] != '"'))
+            buf += '"';
+    }
+
+    // Write the {"key":value} or {"key":[value]} object.
+    // The key e.g. FPSTR(__func__) of the setter is written directly without a temporary String.
+    template <typename K>
+    void setField(String &buf, K key, const char *value, bool isString, bool isArray = false)
+    {
+        clear(buf);
+        buf += FPSTR("{\"");
+        buf += key;
+        buf += FPSTR("\":");
+        if (isArray)
+            buf += '[';
+        addValue(buf, value, isString);
+        if (isArray)
+            buf += ']';
+        buf += '}';
+    }
+
+    template <typename K>
+    void addMapArrayMember(String *buf, size_t size, uint8_t index, K key, const char *memberValue, bool isString)
     {
         if (index < size)
         {
             if (buf[index].length() == 0)
+                setField(buf[index], key, memberValue, isString, true);
+            else if (!buf[index].endsWith(FPSTR("]}")))
+                addMember(buf[index], memberValue, isString, FPSTR("]}"));
+            else
             {
-                String temp;
-                jut.addArray(temp, memberValue, isString, true);
-                jut.addObject(buf[index], key, temp, false, true);
+                // Append in place of the closing "]}" of the array member.
+                buf[index].remove(buf[index].length() - 2);
+                buf[index] += ',';
+                if (isString)
+                    buf[index] += '"';
+                buf[index] += memberValue;
+                if (isString)
+                    buf[index] += '"';
+                buf[index] += FPSTR("]}");
             }
-            else
-                addMember(buf[index], memberValue, isString, "]}");
-
-            getBuf(buf, size);
         }
     }
 
+    // Join the members of the field objects (buf[1] to buf[size - 1]) into buf[0] with a single allocation.
     void getBuf(String *buf, size_t size)
     {
-        clear(buf[0]);
+        size_t len = 0;
         for (size_t i = 1; i < size; i++)
-            addObject(buf[0], buf[i], "}", i == 0);
-    }
+            len += buf[i].length();
 
-    void setObject(String *buf, size_t size, uint8_t index, const String &key, const String &value, bool isString, bool last)
-    {
-        if (index < size)
+        clear(buf[0]);
+        buf[0].reserve(len + 1);
+
+        for (size_t i = 1; i < size; i++)
         {
-            if (key.length())
+            size_t n = buf[i].length();
+            if (n == 0)
+                continue;
+
+            if (buf[0].length() == 0)
+                buf[0] += buf[i];
+            else if (n > 1)
             {
-                clear(buf[index]);
-                jut.addObject(buf[index], key, value, isString, last);
+                buf[0].remove(buf[0].lastIndexOf('}'));
+                buf[0] += ',';
+                buf[0].concat(buf[i].c_str() + 1, n - 2);
+                buf[0] += '}';
             }
-            getBuf(buf, size);
         }
     }
 
+    template <typename K>
+    void setObject(String *buf, size_t size, uint8_t index, K key, const char *value, bool isString)
+    {
+        if (index < size && key)
+            setField(buf[index], key, value, isString);
+    }
+
     void clearBuf(String *buf, size_t size)
     {
         for (size_t i = 0; i < size; i++)
@@ -172,7 +267,8 @@ class BufWriter
 {
 private:
     ObjectWriter owriter;
-    JSONUtil jut;
+    // The fields were changed and buf[0] should be joined again.
+    bool dirty = false;
 
     template <typename T>
     struct v_number
@@ -188,102 +284,93 @@ private:
         static bool const value = std::is_same<T, const char *>::value || std::is_same<T, std::string>::value || std::is_same<T, String>::value;
     };
 
-    void setObject(String *buf, size_t bufSize, uint8_t index, const String &key, const String &value, bool isString, bool last)
-    {
-        owriter.setObject(buf, bufSize, index, key, value, isString, last);
-    }
-
-public:
-    BufWriter() {}
-    template <typename T1, typename T2>
-    T1 add(T1 ret, bool value, String &buf, const String &name)
-    {
-        clear(buf);
-        jut.addObject(buf, name, owriter.getBoolStr(value), false, true);
-        return ret;
-    }
+    // The value as C string, the string and object values are not copied.
+    const char *toChars(bool value) { return value ? "true" : "false"; }
+    const char *toChars(const char *value) { return value; }
+    const char *toChars(const String &value) { return value.c_str(); }
+    const char *toChars(const std::string &value) { return value.c_str(); }
+    template <typename T>
+    auto toChars(const T &value) -> typename std::enable_if<!v_sring<T>::value && !v_number<T>::value && !std::is_same<T, bool>::value, const char *>::type { return value.c_str(); }
 
-    template <typename T1, typename T2>
-    auto add(T1 ret, const T2 &value, String &buf, const String &name) -> typename std::enable_if<v_number<T2>::value, T1>::type
+    template <typename K>
+    void setObject(String *buf, size_t bufSize, uint8_t index, K key, const char *value, bool isString)
     {
-        clear(buf);
-        jut.addObject(buf, name, String(value), false, true);
-        return ret;
+        owriter.setObject(buf, bufSize, index, key, value, isString);
+        dirty = true;
     }
 
-    template <typename T1, typename T2>
-    auto add(T1 ret, const T2 &value, String &buf, const String &name) -> typename std::enable_if<v_sring<T2>::value, T1>::type
+    template <typename K>
+    void addMapArrayMember(String *buf, size_t bufSize, uint8_t index, K key, const char *memberValue, bool isString)
     {
-        clear(buf);
-        jut.addObject(buf, name, value, true, true);
-        return ret;
+        owriter.addMapArrayMember(buf, bufSize, index, key, memberValue, isString);
+        dirty = true;
     }
 
-    template <typename T1, typename T2>
-    auto add(T1 ret, const T2 &value, String &buf, const String &name) -> typename std::enable_if<(!v_sring<T2>::value && !v_number<T2>::value && !std::is_same<T2, bool>::value), T1>::type
-    {
-        clear(buf);
-        jut.addObject(buf, name, value.c_str(), false, true);
-        return ret;
-    }
+public:
+    BufWriter() {}
 
-    template <typename T1, typename T2>
-    T1 set(T1 ret, bool value, String *buf, size_t bufSize, uint8_t index, const String &name)
+    template <typename T1, typename T2, typename K>
+    auto add(T1 ret, const T2 &value, String &buf, K name) -> typename std::enable_if<v_number<T2>::value, T1>::type
     {
-        setObject(buf, bufSize, index, name, owriter.getBoolStr(value), false, true);
+        char num[FIREBASE_NUMBER_BUF_SIZE];
+        NumberFormat::format(num, value);
+        owriter.setField(buf, name, num, false);
         return ret;
     }
 
-    template <typename T1, typename T2>
-    auto set(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, const String &name) -> typename std::enable_if<v_number<T2>::value, T1>::type
+    template <typename T1, typename T2, typename K>
+    auto add(T1 ret, const T2 &value, String &buf, K name) -> typename std::enable_if<!v_number<T2>::value, T1>::type
     {
-        setObject(buf, bufSize, index, name, String(value), false, true);
+        owriter.setField(buf, name, toChars(value), v_sring<T2>::value);
         return ret;
     }
 
-    template <typename T1, typename T2>
-    auto set(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, const String &name) -> typename std::enable_if<v_sring<T2>::value, T1>::type
+    template <typename T1, typename T2, typename K>
+    auto set(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, K name) -> typename std::enable_if<v_number<T2>::value, T1>::type
     {
-        setObject(buf, bufSize, index, name, value, true, true);
+        char num[FIREBASE_NUMBER_BUF_SIZE];
+        NumberFormat::format(num, value);
+        setObject(buf, bufSize, index, name, num, false);
         return ret;
     }
 
-    template <typename T1, typename T2>
-    auto set(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, const String &name) -> typename std::enable_if<(!v_sring<T2>::value && !v_number<T2>::value && !std::is_same<T2, bool>::value), T1>::type
+    template <typename T1, typename T2, typename K>
+    auto set(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, K name) -> typename std::enable_if<!v_number<T2>::value, T1>::type
     {
-        setObject(buf, bufSize, index, name, value.c_str(), false, true);
+        setObject(buf, bufSize, index, name, toChars(value), v_sring<T2>::value);
         return ret;
     }
 
-    template <typename T1, typename T2>
-    T1 append(T1 ret, bool value, String *buf, size_t bufSize, uint8_t index, const String &name)
+    template <typename T1, typename T2, typename K>
+    auto append(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, K name) -> typename std::enable_if<v_number<T2>::value, T1>::type
     {
-        owriter.addMapArrayMember(buf, bufSize, index, name, owriter.getBoolStr(value), false);
+        char num[FIREBASE_NUMBER_BUF_SIZE];
+        NumberFormat::format(num, value);
+        addMapArrayMember(buf, bufSize, index, name, num, false);
         return ret;
     }
 
-    template <typename T1, typename T2>
-    auto append(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, const String &name) -> typename std::enable_if<v_number<T2>::value, T1>::type
+    template <typename T1, typename T2, typename K>
+    auto append(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, K name) -> typename std::enable_if<!v_number<T2>::value, T1>::type
     {
-        owriter.addMapArrayMember(buf, bufSize, index, name, String(value), false);
+        addMapArrayMember(buf, bufSize, index, name, toChars(value), v_sring<T2>::value);
         return ret;
     }
-
-    template <typename T1, typename T2>
-    auto append(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, const String &name) -> typename std::enable_if<v_sring<T2>::value, T1>::type
+    void clear(String &buf) { buf.remove(0, buf.length()); }
+    void clear(String *buf, size_t bufSize)
     {
-        owriter.addMapArrayMember(buf, bufSize, index, name, value, true);
-        return ret;
+        owriter.clearBuf(buf, bufSize);
+        dirty = false;
     }
 
-    template <typename T1, typename T2>
-    auto append(T1 ret, const T2 &value, String *buf, size_t bufSize, uint8_t index, const String &name) -> typename std::enable_if<(!v_sring<T2>::value && !v_number<T2>::value && !std::is_same<T2, bool>::value), T1>::type
+    // The fields are joined once when the object content is used e.g. as the request payload.
+    const char *get(String *buf, size_t bufSize)
     {
-        owriter.addMapArrayMember(buf, bufSize, index, name, value.c_str(), false);
-        return ret;
+        if (dirty)
+            owriter.getBuf(buf, bufSize);
+        dirty = false;
+        return buf[0].c_str();
     }
-    void clear(String &buf) { buf.remove(0, buf.length()); }
-    void clear(String *buf, size_t bufSize) { owriter.clearBuf(buf, bufSize); }
 };
 
 class BaseO1 : public Printable
@@ -310,13 +397,13 @@ class BaseO2 : public Printable
 
 protected:
     static const size_t bufSize = 2;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO2() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -330,13 +417,13 @@ class BaseO4 : public Printable
 
 protected:
     static const size_t bufSize = 4;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO4() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -350,13 +437,13 @@ class BaseO6 : public Printable
 
 protected:
     static const size_t bufSize = 6;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO6() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -369,13 +456,13 @@ class BaseO8 : public Printable
 {
 protected:
     static const size_t bufSize = 8;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO8() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -389,13 +476,13 @@ class BaseO10 : public Printable
 
 protected:
     static const size_t bufSize = 10;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO10() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -409,13 +496,13 @@ class BaseO12 : public Printable
 
 protected:
     static const size_t bufSize = 12;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO12() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -428,13 +515,13 @@ class BaseO16 : public Printable
 {
 protected:
     static const size_t bufSize = 16;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO16() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -447,13 +534,13 @@ class BaseO26 : public Printable
 {
 protected:
     static const size_t bufSize = 26;
-    String buf[bufSize];
-    BufWriter wr;
+    mutable String buf[bufSize];
+    mutable BufWriter wr;
 
 public:
     BaseO26() {}
-    const char *c_str() const { return buf[0].c_str(); }
-    size_t printTo(Print &p) const { return p.print(buf[0].c_str()); }
+    const char *c_str() const { return wr.get(buf, bufSize); }
+    size_t printTo(Print &p) const { return p.print(c_str()); }
     void clear() { wr.clear(buf, bufSize); }
     void setContent(const String &content)
     {
@@ -30,6 +30,7 @@
 #include "./Config.h"
 #include "./core/StringUtil.h"
 #include "./core/Memory.h"
+#include "./core/JSONTokenizer.h"
 
 class URLUtil
 {
@@ -211,13 +212,17 @@ public:
 
     void updateDownloadURL(String &url, const String &payload)
     {
-        int p1 = payload.indexOf(FPSTR("\"downloadTokens\": \""));
-        if (p1 > -1)
+        JSONTokenizer tk(payload.c_str(), payload.length());
+        json_token_t token;
+        while ((token = tk.next()) != json_token_none && token != json_token_error)
         {
-            p1 += 19;
-            int p2 = payload.indexOf("\"", p1);
-            if (p2 > -1)
-                url.replace(FPSTR("a82781ce-a115-442f-bac6-a52f7f63b3e8"), payload.substring(p1, p2));
+            if (token == json_token_value && tk.depth() == 1 && tk.keyIs("downloadTokens"))
+            {
+                String tokens;
+                tk.get(tokens);
+                url.replace(FPSTR("a82781ce-a115-442f-bac6-a52f7f63b3e8"), tokens);
+                return;
+            }
         }
     }
 };
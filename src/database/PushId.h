@@ -0,0 +1,167 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef DATABASE_PUSH_ID_H
+#define DATABASE_PUSH_ID_H
+
+#include <Arduino.h>
+#include "./Config.h"
+
+#if defined(ENABLE_DATABASE)
+
+#if defined(ESP32)
+#include <esp_system.h>
+#endif
+
+// The push ID length, the 8 characters timestamp and 12 random characters.
+#define FIREBASE_PUSH_ID_LENGTH 20
+
+/**
+ * The push ID generator that creates the node keys in the same format as the push IDs of the official Firebase SDKs.
+ *
+ * The key is the timestamp in ms (8 characters) followed by 12 random characters, encoded with the
+ * lexicographically ordered alphabet then the keys are sorted by their creation time.
+ * The keys that are created in the same ms are kept in order by incrementing the random part of the previous key.
+ *
+ * The timestamp is the device uptime (millis) plus the server time offset, the keys are in the server time order
+ * after the offset was set.
+ */
+class PushIdGenerator
+{
+public:
+    PushIdGenerator() {}
+
+    /**
+     * Set the time offset in ms that is added to the device uptime (millis) to get the server time.
+     *
+     * @param offsetMs The server time offset in ms.
+     */
+    void setTimeOffset(int64_t offsetMs) { offset_ms = offsetMs; }
+
+    /**
+     * Get the server time offset in ms.
+     */
+    int64_t timeOffset() const { return offset_ms; }
+
+    /**
+     * Get the device uptime in ms, which is not wrapped after 49 days.
+     */
+    uint64_t uptime()
+    {
+        uint32_t ms = millis();
+        if (ms < last_millis)
+            millis_wraps++;
+        last_millis = ms;
+        return (static_cast<uint64_t>(millis_wraps) << 32) | ms;
+    }
+
+    /**
+     * Get the estimated server time in ms.
+     */
+    uint64_t now()
+    {
+        int64_t ms = static_cast<int64_t>(uptime()) + offset_ms;
+        return ms > 0 ? static_cast<uint64_t>(ms) : 0;
+    }
+
+    /**
+     * Create the push ID.
+     *
+     * @param out The output buffer of at least 21 bytes (FIREBASE_PUSH_ID_LENGTH + 1).
+     */
+    void generate(char *out)
+    {
+        static const char chars[] PROGMEM = "-0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+
+        uint64_t ms = now();
+
+        // The time never goes backward e.g. after the offset was updated, to keep the keys in order.
+        bool same = ms <= last_ms && has_last;
+        if (same)
+            ms = last_ms;
+
+        last_ms = ms;
+        has_last = true;
+
+        for (int i = 7; i >= 0; i--)
+        {
+            out[i] = pgm_read_byte(&chars[ms & 0x3f]);
+            ms >>= 6;
+        }
+
+        if (!same)
+        {
+            for (int i = 0; i < 12; i++)
+                last_rand[i] = randomChar();
+        }
+        else
+        {
+            // Increment the random part, the carried characters are wrapped to 0.
+            int i = 11;
+            for (; i >= 0 && last_rand[i] == 63; i--)
+                last_rand[i] = 0;
+            if (i >= 0)
+                last_rand[i]++;
+        }
+
+        for (int i = 0; i < 12; i++)
+            out[8 + i] = pgm_read_byte(&chars[last_rand[i]]);
+
+        out[FIREBASE_PUSH_ID_LENGTH] = '\0';
+    }
+
+    /**
+     * Create the push ID.
+     *
+     * @return String The push ID.
+     */
+    String next()
+    {
+        char buf[FIREBASE_PUSH_ID_LENGTH + 1];
+        generate(buf);
+        return buf;
+    }
+
+private:
+    int64_t offset_ms = 0;
+    uint64_t last_ms = 0;
+    uint32_t last_millis = 0, millis_wraps = 0;
+    uint8_t last_rand[12];
+    bool has_last = false;
+
+    uint8_t randomChar()
+    {
+#if defined(ESP32)
+        return esp_random() & 0x3f;
+#elif defined(ESP8266)
+        return ESP.random() & 0x3f;
+#else
+        return random(64);
+#endif
+    }
+};
+
+#endif
+
+#endif
@@ -27,6 +27,7 @@
 #include <Arduino.h>
 #include "./core/FirebaseApp.h"
 #include "./database/DataOptions.h"
+#include "./database/PushId.h"
 
 using namespace firebase;
 
@@ -71,6 +72,9 @@ public:
 
     ~RealtimeDatabase()
     {
+        for (size_t i = 0; i < sent_batches.size(); i++)
+            delete sent_batches[i];
+        sent_batches.clear();
     }
 
     /**
@@ -469,6 +473,77 @@ public:
         storeAsync(aClient, path, value, async_request_handler_t::http_put, true, nullptr, cb, uid);
     }
 
+    /**
+     * Set the JSON content that is written by the JSON writer callback to database.
+     *
+     * The content is sent while it is written, in the chunks of 2048 bytes,
+     * then the large JSON content can be sent without keeping the whole content in memory.
+     *
+     * ### Example
+     * ```cpp
+     * void writeJSON(JSONWriter &writer)
+     * {
+     *   writer.beginObject();
+     *   writer.add("name", "Jack");
+     *   writer.add("age", 30);
+     *   writer.endObject();
+     * }
+     *
+     * Database.set(aClient, "/path/to/data", writeJSON, aResult);
+     * ```
+     * @param aClient The async client.
+     * @param path The node path to set the value.
+     * @param writer The JSON writer callback (JSONWriterCallback).
+     * @param aResult The async result (AsyncResult).
+     *
+     * The callback will be called twice, to calculate the content length and to write the content while sending.
+     * It should write the same content every time it was called and should not depend on the number of calls.
+     * The content is sent in one pass, the loop is blocked until all content was sent (also for the async request).
+     * The request fails when the written content is not the same length as calculated.
+     */
+    void set(AsyncClientClass &aClient, const String &path, JSONWriterCallback writer, AsyncResult &aResult)
+    {
+        async_request_data_t aReq(&aClient, path, async_request_handler_t::http_put, slot_options_t(false, false, true, false, false, false), nullptr, nullptr, &aResult, nullptr);
+        aReq.writer = writer;
+        asyncRequest(aReq);
+    }
+
+    /**
+     * Set the JSON content that is written by the JSON writer callback to database.
+     *
+     * The content is sent while it is written, in the chunks of 2048 bytes,
+     * then the large JSON content can be sent without keeping the whole content in memory.
+     *
+     * ### Example
+     * ```cpp
+     * void writeJSON(JSONWriter &writer)
+     * {
+     *   writer.beginObject();
+     *   writer.add("name", "Jack");
+     *   writer.add("age", 30);
+     *   writer.endObject();
+     * }
+     *
+     * Database.set(aClient, "/path/to/data", writeJSON, cb);
+     * ```
+     * @param aClient The async client.
+     * @param path The node path to set the value.
+     * @param writer The JSON writer callback (JSONWriterCallback).
+     * @param cb The async result callback (AsyncResultCallback).
+     * @param uid The user specified UID of async result (optional).
+     *
+     * The callback will be called twice, to calculate the content length and to write the content while sending.
+     * It should write the same content every time it was called and should not depend on the number of calls.
+     * The content is sent in one pass, the loop is blocked until all content was sent (also for the async request).
+     * The request fails when the written content is not the same length as calculated.
+     */
+    void set(AsyncClientClass &aClient, const String &path, JSONWriterCallback writer, AsyncResultCallback cb, const String &uid = "")
+    {
+        async_request_data_t aReq(&aClient, path, async_request_handler_t::http_put, slot_options_t(false, false, true, false, false, false), nullptr, nullptr, nullptr, cb, uid);
+        aReq.writer = writer;
+        asyncRequest(aReq);
+    }
+
     /**
      * Set content from file to database.
      *
@@ -583,6 +658,13 @@ public:
     template <typename T = const char *>
     String push(AsyncClientClass &aClient, const String &path, T value)
     {
+        if (local_push_id)
+        {
+            AsyncResult result;
+            String name = push_id.next();
+            return storeAsync(aClient, pushPath(path, name), value, async_request_handler_t::http_put, false, &result, NULL, "", name) ? name : String();
+        }
+
         ValueConverter vcon;
         AsyncResult result;
         String payload;
@@ -614,6 +696,13 @@ public:
     template <typename T = const char *>
     void push(AsyncClientClass &aClient, const String &path, T value, AsyncResult &aResult)
     {
+        if (local_push_id)
+        {
+            String name = push_id.next();
+            storeAsync(aClient, pushPath(path, name), value, async_request_handler_t::http_put, true, &aResult, NULL, "", name);
+            return;
+        }
+
         ValueConverter vcon;
         String payload;
         vcon.getVal<T>(payload, value);
@@ -644,6 +733,13 @@ public:
     template <typename T = const char *>
     void push(AsyncClientClass &aClient, const String &path, T value, AsyncResultCallback cb, const String &uid = "")
     {
+        if (local_push_id)
+        {
+            String name = push_id.next();
+            storeAsync(aClient, pushPath(path, name), value, async_request_handler_t::http_put, true, nullptr, cb, uid, name);
+            return;
+        }
+
         ValueConverter vcon;
         String payload;
         vcon.getVal<T>(payload, value);
@@ -651,6 +747,77 @@ public:
         asyncRequest(aReq, payload.c_str());
     }
 
+    /**
+     * Push the JSON content that is written by the JSON writer callback to database.
+     *
+     * The content is sent while it is written, in the chunks of 2048 bytes,
+     * then the large JSON content can be sent without keeping the whole content in memory.
+     *
+     * ### Example
+     * ```cpp
+     * void writeJSON(JSONWriter &writer)
+     * {
+     *   writer.beginObject();
+     *   writer.add("name", "Jack");
+     *   writer.add("age", 30);
+     *   writer.endObject();
+     * }
+     *
+     * Database.push(aClient, "/path/to/data", writeJSON, aResult);
+     * ```
+     * @param aClient The async client.
+     * @param path The node path to push the value.
+     * @param writer The JSON writer callback (JSONWriterCallback).
+     * @param aResult The async result (AsyncResult).
+     *
+     * The callback will be called twice, to calculate the content length and to write the content while sending.
+     * It should write the same content every time it was called and should not depend on the number of calls.
+     * The content is sent in one pass, the loop is blocked until all content was sent (also for the async request).
+     * The request fails when the written content is not the same length as calculated.
+     */
+    void push(AsyncClientClass &aClient, const String &path, JSONWriterCallback writer, AsyncResult &aResult)
+    {
+        async_request_data_t aReq(&aClient, path, async_request_handler_t::http_post, slot_options_t(false, false, true, false, false, false), nullptr, nullptr, &aResult, nullptr);
+        aReq.writer = writer;
+        asyncRequest(aReq);
+    }
+
+    /**
+     * Push the JSON content that is written by the JSON writer callback to database.
+     *
+     * The content is sent while it is written, in the chunks of 2048 bytes,
+     * then the large JSON content can be sent without keeping the whole content in memory.
+     *
+     * ### Example
+     * ```cpp
+     * void writeJSON(JSONWriter &writer)
+     * {
+     *   writer.beginObject();
+     *   writer.add("name", "Jack");
+     *   writer.add("age", 30);
+     *   writer.endObject();
+     * }
+     *
+     * Database.push(aClient, "/path/to/data", writeJSON, cb);
+     * ```
+     * @param aClient The async client.
+     * @param path The node path to push the value.
+     * @param writer The JSON writer callback (JSONWriterCallback).
+     * @param cb The async result callback (AsyncResultCallback).
+     * @param uid The user specified UID of async result (optional).
+     *
+     * The callback will be called twice, to calculate the content length and to write the content while sending.
+     * It should write the same content every time it was called and should not depend on the number of calls.
+     * The content is sent in one pass, the loop is blocked until all content was sent (also for the async request).
+     * The request fails when the written content is not the same length as calculated.
+     */
+    void push(AsyncClientClass &aClient, const String &path, JSONWriterCallback writer, AsyncResultCallback cb, const String &uid = "")
+    {
+        async_request_data_t aReq(&aClient, path, async_request_handler_t::http_post, slot_options_t(false, false, true, false, false, false), nullptr, nullptr, nullptr, cb, uid);
+        aReq.writer = writer;
+        asyncRequest(aReq);
+    }
+
     /**
      * Push content from file to database.
      *
@@ -799,6 +966,77 @@ public:
         storeAsync(aClient, path, value, async_request_handler_t::http_patch, true, nullptr, cb, uid);
     }
 
+    /**
+     * Update (patch) the JSON content that is written by the JSON writer callback to database.
+     *
+     * The content is sent while it is written, in the chunks of 2048 bytes,
+     * then the large JSON content can be sent without keeping the whole content in memory.
+     *
+     * ### Example
+     * ```cpp
+     * void writeJSON(JSONWriter &writer)
+     * {
+     *   writer.beginObject();
+     *   writer.add("name", "Jack");
+     *   writer.add("age", 30);
+     *   writer.endObject();
+     * }
+     *
+     * Database.update(aClient, "/path/to/data", writeJSON, aResult);
+     * ```
+     * @param aClient The async client.
+     * @param path The node path to update.
+     * @param writer The JSON writer callback (JSONWriterCallback).
+     * @param aResult The async result (AsyncResult).
+     *
+     * The callback will be called twice, to calculate the content length and to write the content while sending.
+     * It should write the same content every time it was called and should not depend on the number of calls.
+     * The content is sent in one pass, the loop is blocked until all content was sent (also for the async request).
+     * The request fails when the written content is not the same length as calculated.
+     */
+    void update(AsyncClientClass &aClient, const String &path, JSONWriterCallback writer, AsyncResult &aResult)
+    {
+        async_request_data_t aReq(&aClient, path, async_request_handler_t::http_patch, slot_options_t(false, false, true, false, false, false), nullptr, nullptr, &aResult, nullptr);
+        aReq.writer = writer;
+        asyncRequest(aReq);
+    }
+
+    /**
+     * Update (patch) the JSON content that is written by the JSON writer callback to database.
+     *
+     * The content is sent while it is written, in the chunks of 2048 bytes,
+     * then the large JSON content can be sent without keeping the whole content in memory.
+     *
+     * ### Example
+     * ```cpp
+     * void writeJSON(JSONWriter &writer)
+     * {
+     *   writer.beginObject();
+     *   writer.add("name", "Jack");
+     *   writer.add("age", 30);
+     *   writer.endObject();
+     * }
+     *
+     * Database.update(aClient, "/path/to/data", writeJSON, cb);
+     * ```
+     * @param aClient The async client.
+     * @param path The node path to update.
+     * @param writer The JSON writer callback (JSONWriterCallback).
+     * @param cb The async result callback (AsyncResultCallback).
+     * @param uid The user specified UID of async result (optional).
+     *
+     * The callback will be called twice, to calculate the content length and to write the content while sending.
+     * It should write the same content every time it was called and should not depend on the number of calls.
+     * The content is sent in one pass, the loop is blocked until all content was sent (also for the async request).
+     * The request fails when the written content is not the same length as calculated.
+     */
+    void update(AsyncClientClass &aClient, const String &path, JSONWriterCallback writer, AsyncResultCallback cb, const String &uid = "")
+    {
+        async_request_data_t aReq(&aClient, path, async_request_handler_t::http_patch, slot_options_t(false, false, true, false, false, false), nullptr, nullptr, nullptr, cb, uid);
+        aReq.writer = writer;
+        asyncRequest(aReq);
+    }
+
     /**
      * Remove node from database
      *
@@ -816,7 +1054,7 @@ public:
         AsyncResult result;
         async_request_data_t aReq(&aClient, path, async_request_handler_t::http_delete, slot_options_t(), nullptr, nullptr, &result, nullptr);
         asyncRequest(aReq);
-        return result.rtdbResult.null_etag && String(result.rtdbResult.data()).indexOf("null") > -1;
+        return result.rtdbResult.null_etag && result.rtdbResult.data().indexOf("null") > -1;
     }
 
     /**
@@ -878,6 +1116,9 @@ public:
      */
     void loop()
     {
+        if (batch.entries.size() && millis() - batch.ms >= batch.window_ms)
+            flushWrites();
+
         for (size_t i = 0; i < cVec.size(); i++)
         {
             AsyncClientClass *aClient = reinterpret_cast<AsyncClientClass *>(cVec[i]);
@@ -887,6 +1128,144 @@ public:
                 aClient->handleRemove();
             }
         }
+
+        returnWriteBatches();
+    }
+
+    /**
+     * Collect the async set and update writes that are issued within the time window and send them as one multi-location update.
+     *
+     * The writes to the same path are merged and the later value wins. The update result is returned to the async result
+     * or callback of each write, with the value of that write as the payload.
+     * The pending writes are sent before any other request of this database, then the order of requests is kept.
+     * The sync writes, the writes with ETag, the push (unless setLocalPushId is enabled) and the writes with JSON writer or file are not batched.
+     *
+     * ### Example
+     * ```cpp
+     * Database.setWriteBatch(1000);
+     * Database.set<int>(aClient, "/sensors/t1", 25, cb, "t1");
+     * Database.set<int>(aClient, "/sensors/t2", 26, cb, "t2");
+     * ```
+     * @param windowMs The time in ms to collect the writes before sending, 0 for disabling the batching.
+     * @param maxSize The batch payload size in bytes to send the writes immediately.
+     */
+    void setWriteBatch(uint32_t windowMs, size_t maxSize = 2048)
+    {
+        batch.window_ms = windowMs;
+        batch.max_size = maxSize;
+        if (windowMs == 0)
+            flushWrites();
+    }
+
+    /**
+     * Send the pending batched writes now.
+     */
+    void flushWrites()
+    {
+        if (batch.entries.size() == 0)
+            return;
+
+        write_batch_t *wb = new write_batch_t();
+        wb->sinks.swap(batch.sinks);
+        AsyncClientClass *aClient = batch.aClient;
+
+        String payload;
+        payload.reserve(batch.size + 2);
+        payload += '{';
+        for (size_t i = 0; i < batch.entries.size(); i++)
+        {
+            if (i > 0)
+                payload += ',';
+            payload += '"';
+            payload += batch.entries[i].path;
+            payload += FPSTR("\":");
+            payload += batch.entries[i].value;
+        }
+        payload += '}';
+
+        batch.entries.clear();
+        batch.aClient = nullptr;
+        batch.size = 0;
+
+        sent_batches.push_back(wb);
+        DatabaseOptions options;
+        async_request_data_t aReq(aClient, "/", async_request_handler_t::http_patch, slot_options_t(false, false, true, payload.indexOf("\".sv\"") > -1, false, false), &options, nullptr, &wb->result, nullptr);
+        asyncRequest(aReq, payload.c_str());
+    }
+
+    /**
+     * Create the push ID (node key) locally.
+     *
+     * The key has the same format as the key that is created by the server when pushing, the 8 characters timestamp
+     * followed by 12 random characters, and the keys are sorted by their creation time.
+     *
+     * ### Example
+     * ```cpp
+     * String name = Database.pushId();
+     * Database.set<int>(aClient, "/path/to/data/" + name, 123, aResult);
+     * ```
+     * @return String The push ID.
+     */
+    String pushId() { return push_id.next(); }
+
+    /**
+     * Enable or disable the locally created keys for push.
+     *
+     * When enabled, the push with value creates the key locally (pushId) and writes the value to the new key with set (PUT)
+     * instead of POST, then it can be batched (setWriteBatch) and retried without creating the duplicate nodes.
+     * The name of the new node is available from the async result (AsyncResult::to<RealtimeDatabaseResult>().name()) as usual.
+     * The push with JSON writer or file still uses the key that is created by the server.
+     *
+     * The server time offset should be set (syncServerTime or setServerTimeOffset) for the keys to be ordered
+     * with the keys that are created by the server and other devices.
+     *
+     * @param enable The boolean value to enable the locally created keys.
+     */
+    void setLocalPushId(bool enable) { local_push_id = enable; }
+
+    /**
+     * Set the server time offset in ms that is added to the device uptime (millis) when creating the push ID.
+     *
+     * @param offsetMs The server time offset in ms.
+     */
+    void setServerTimeOffset(int64_t offsetMs) { push_id.setTimeOffset(offsetMs); }
+
+    /**
+     * Get the server time offset in ms that is used when creating the push ID.
+     */
+    int64_t serverTimeOffset() const { return push_id.timeOffset(); }
+
+    /**
+     * Measure the server time offset that is used when creating the push ID.
+     *
+     * The server timestamp is written to the node path, and the offset is the server time minus the device uptime (millis)
+     * at the middle of the request round trip.
+     *
+     * ### Example
+     * ```cpp
+     * Database.syncServerTime(aClient, "/devices/device1/lastSync");
+     * ```
+     * @param aClient The async client.
+     * @param path The node path to write the server timestamp, which should be allowed to write by the security rules.
+     * @return boolean value indicates the operating status.
+     */
+    bool syncServerTime(AsyncClientClass &aClient, const String &path)
+    {
+        AsyncResult result;
+        uint64_t ms = push_id.uptime();
+        async_request_data_t aReq(&aClient, path, async_request_handler_t::http_put, slot_options_t(false, false, false, true, false, false), nullptr, nullptr, &result, NULL);
+        asyncRequest(aReq, "{\".sv\":\"timestamp\"}");
+        uint64_t rtt = push_id.uptime() - ms;
+
+        if (result.lastError.code() != 0)
+            return false;
+
+        uint64_t server_ms = strtoull(result.c_str(), nullptr, 10);
+        if (server_ms == 0)
+            return false;
+
+        push_id.setTimeOffset(static_cast<int64_t>(server_ms) - static_cast<int64_t>(ms + rtt / 2));
+        return true;
     }
 
 private:
@@ -907,6 +1286,8 @@ private:
         file_config_data *file = nullptr;
         AsyncResult *aResult = nullptr;
         AsyncResultCallback cb = NULL;
+        JSONWriterCallback writer = NULL;
+        String node_name; // The locally created push ID.
         async_request_data_t() {}
         async_request_data_t(AsyncClientClass *aClient, const String &path, async_request_handler_t::http_request_method method, slot_options_t opt, DatabaseOptions *options, file_config_data *file, AsyncResult *aResult, AsyncResultCallback cb, const String &uid = "")
         {
@@ -922,16 +1303,225 @@ private:
         }
     };
 
+    struct batch_entry_t
+    {
+        String path; // The root-relative path, JSON escaped.
+        String value;
+    };
+
+    struct batch_sink_t
+    {
+        AsyncResult *aResult = nullptr;
+        AsyncResultCallback cb = NULL;
+        String uid, path, payload, name;
+    };
+
+    // The sent batch, its result is returned to all sinks when it is done.
+    struct write_batch_t
+    {
+        AsyncResult result;
+        std::vector<batch_sink_t> sinks;
+    };
+
+    struct batch_data_t
+    {
+        AsyncClientClass *aClient = nullptr;
+        uint32_t window_ms = 0;
+        size_t max_size = 2048, size = 0;
+        unsigned long ms = 0;
+        std::vector<batch_entry_t> entries;
+        std::vector<batch_sink_t> sinks;
+    };
+
+    batch_data_t batch;
+    std::vector<write_batch_t *> sent_batches;
+    PushIdGenerator push_id;
+    bool local_push_id = false;
+
+    String pushPath(const String &path, const String &name)
+    {
+        String buf = path;
+        if (buf.length() == 0 || buf[buf.length() - 1] != '/')
+            buf += '/';
+        buf += name;
+        return buf;
+    }
+
+    // The path a is the ancestor of (or the same as) the path b.
+    bool isAncestor(const String &a, const String &b)
+    {
+        return b.length() >= a.length() && strncmp(a.c_str(), b.c_str(), a.length()) == 0 && (b.length() == a.length() || b[a.length()] == '/');
+    }
+
+    void addBatchEntry(const String &path, const String &value)
+    {
+        for (size_t i = 0; i < batch.entries.size(); i++)
+        {
+            if (batch.entries[i].path == path)
+            {
+                batch.size = batch.size - batch.entries[i].value.length() + value.length();
+                batch.entries[i].value = value;
+                return;
+            }
+        }
+        batch_entry_t entry;
+        entry.path = path;
+        entry.value = value;
+        batch.size += path.length() + value.length() + 4;
+        batch.entries.push_back(entry);
+    }
+
+    // Split the members of the update object into the root-relative paths, returns false when it is not a JSON object.
+    bool splitMembers(const String &base, const String &payload, std::vector<batch_entry_t> &entries)
+    {
+        JSONTokenizer tk(payload.c_str(), payload.length());
+        if (tk.next() != json_token_begin_object)
+            return false;
+
+        batch_entry_t entry;
+        size_t start = 0;
+        json_token_t token;
+        while ((token = tk.next()) != json_token_none && token != json_token_error)
+        {
+            size_t pos = tk.position();
+            if (token == json_token_key && tk.depth() == 1)
+            {
+                entry.path = base;
+                if (base.length())
+                    entry.path += '/';
+                entry.path += payload.substring(pos, pos + tk.keyLength());
+            }
+            else if (token == json_token_value && tk.depth() == 1)
+            {
+                entry.value = tk.isString() ? payload.substring(pos - 1, pos + tk.length() + 1) : payload.substring(pos, pos + tk.length());
+                entries.push_back(entry);
+            }
+            else if ((token == json_token_begin_object || token == json_token_begin_array) && tk.depth() == 2)
+                start = pos;
+            else if ((token == json_token_end_object || token == json_token_end_array) && tk.depth() == 1)
+            {
+                entry.value = payload.substring(start, pos + 1);
+                entries.push_back(entry);
+            }
+            else if (token == json_token_end_object && tk.depth() == 0)
+                return entries.size() > 0;
+        }
+        return false;
+    }
+
+    bool addWrite(AsyncClientClass &aClient, const String &path, const String &payload, bool update, AsyncResult *aResult, AsyncResultCallback cb, const String &uid, const String &name)
+    {
+        String base;
+        for (size_t i = 0; i < path.length(); i++)
+        {
+            if ((path[i] == '/' && (base.length() == 0 || i == path.length() - 1)))
+                continue;
+            if (path[i] == '"' || path[i] == '\\')
+                base += '\\';
+            base += path[i];
+        }
+
+        std::vector<batch_entry_t> entries;
+        if (update)
+        {
+            if (!splitMembers(base, payload, entries))
+                return false;
+        }
+        else if (base.length() == 0)
+            return false;
+        else
+        {
+            batch_entry_t entry;
+            entry.path = base;
+            entry.value = payload;
+            entries.push_back(entry);
+        }
+
+        // The multi-location update does not allow the ancestor and its descendant paths.
+        bool overlapped = false;
+        for (size_t i = 0; i < entries.size() && !overlapped; i++)
+        {
+            for (size_t j = 0; j < batch.entries.size() && !overlapped; j++)
+                overlapped = entries[i].path != batch.entries[j].path && (isAncestor(entries[i].path, batch.entries[j].path) || isAncestor(batch.entries[j].path, entries[i].path));
+        }
+
+        if (batch.aClient && (batch.aClient != &aClient || overlapped))
+            flushWrites();
+
+        if (batch.entries.size() == 0)
+        {
+            batch.aClient = &aClient;
+            batch.ms = millis();
+        }
+
+        for (size_t i = 0; i < entries.size(); i++)
+            addBatchEntry(entries[i].path, entries[i].value);
+
+        batch_sink_t sink;
+        sink.aResult = aResult;
+        sink.cb = cb;
+        sink.uid = uid;
+        sink.path = path;
+        sink.payload = payload;
+        sink.name = name;
+        batch.sinks.push_back(sink);
+
+        if (batch.size >= batch.max_size)
+            flushWrites();
+        return true;
+    }
+
+    // Return the result of the done batches to the async result or callback of each write.
+    void returnWriteBatches()
+    {
+        for (size_t i = 0; i < sent_batches.size();)
+        {
+            write_batch_t *wb = sent_batches[i];
+            if (!wb->result.data_available && !wb->result.error_available)
+            {
+                i++;
+                continue;
+            }
+
+            for (size_t j = 0; j < wb->sinks.size(); j++)
+            {
+                batch_sink_t &sink = wb->sinks[j];
+                AsyncResult temp;
+                AsyncResult *aResult = sink.aResult ? sink.aResult : &temp;
+                aResult->val[ares_ns::res_uid] = sink.uid;
+                aResult->setPath(sink.path);
+                aResult->lastError = wb->result.lastError;
+                aResult->error_available = wb->result.error_available;
+                aResult->rtdbResult.setNodeName(sink.name);
+                if (!wb->result.error_available)
+                    aResult->setPayload(sink.payload);
+                if (sink.cb)
+                    sink.cb(*aResult);
+            }
+
+            delete wb;
+            sent_batches.erase(sent_batches.begin() + i);
+        }
+    }
+
     template <typename T = object_t>
-    bool storeAsync(AsyncClientClass &aClient, const String &path, const T &value, async_request_handler_t::http_request_method mode, bool async, AsyncResult *aResult, AsyncResultCallback cb, const String &uid)
+    bool storeAsync(AsyncClientClass &aClient, const String &path, const T &value, async_request_handler_t::http_request_method mode, bool async, AsyncResult *aResult, AsyncResultCallback cb, const String &uid, const String &name = "")
     {
         ValueConverter vcon;
         String payload;
         vcon.getVal<T>(payload, value);
+
+        if (async && batch.window_ms > 0 && aClient.reqEtag.length() == 0 && (mode == async_request_handler_t::http_put || mode == async_request_handler_t::http_patch))
+        {
+            if (addWrite(aClient, path, payload, mode == async_request_handler_t::http_patch, aResult, cb, uid, name))
+                return true;
+        }
+
         DatabaseOptions options;
         if (!async && aClient.reqEtag.length() == 0)
             options.silent = true;
         async_request_data_t aReq(&aClient, path, mode, slot_options_t(false, false, async, payload.indexOf("\".sv\"") > -1, false, false), &options, nullptr, aResult, cb, uid);
+        aReq.node_name = name;
         asyncRequest(aReq, payload.c_str());
         if (!async)
             return aResult->lastError.code() == 0;
@@ -940,6 +1530,10 @@ private:
 
     void asyncRequest(async_request_data_t &request, const char *payload = "")
     {
+        // The pending batched writes are sent first to keep the order of requests.
+        if (batch.entries.size())
+            flushWrites();
+
         app_token_t *app_token = appToken();
 
         if (!app_token)
@@ -951,12 +1545,14 @@ private:
 
         addParams(request.opt.auth_param, extras, request.method, request.options, request.file);
 
+        request.opt.payload_size = strlen(payload);
         async_data_item_t *sData = request.aClient->createSlot(request.opt);
 
         if (!sData)
             return setClientError(request, FIREBASE_ERROR_OPERATION_CANCELLED);
 
         request.aClient->newRequest(sData, service_url, request.path, extras, request.method, request.opt, request.uid);
+        sData->aResult.rtdbResult.setNodeName(request.node_name);
 
         if (request.file)
             sData->request.file_data.copy(*request.file);
@@ -983,6 +1579,8 @@ private:
             sData->request.val[req_hndlr_ns::payload] = payload;
             request.aClient->setContentLength(sData, strlen(payload));
         }
+        else if (request.writer)
+            request.aClient->setJSONWriter(sData, request.writer);
 
         if (request.cb)
             sData->cb = request.cb;
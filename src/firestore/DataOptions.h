@@ -419,11 +419,13 @@ class Document : public BaseO4
 
 private:
     Values::MapValue mv;
+    size_t cap = 0;
     ObjectWriter owriter;
     JSONUtil jut;
 
     Document &getBuf()
     {
+        cap = 0;
         buf[2] = mv.c_str();
         buf[3].remove(0, buf[3].length());
         if (buf[1].length())
@@ -441,6 +443,16 @@ private:
         return *this;
     }
 
+    // The fields object is always the last member of the document,
+    // the new field is appended in place of its closing brackets.
+    Document &appendField(const String &key, T value)
+    {
+        const char *v = value.val();
+        mv.add(key, value);
+        owriter.appendPair(buf[0], cap, key, v, FPSTR("}}"));
+        return *this;
+    }
+
 public:
     /**
      * A Firestore document constructor with document resource name.
@@ -470,10 +482,22 @@ public:
      */
     Document &add(const String &key, T value)
     {
+        if (strlen(mv.c_str()))
+            return appendField(key, value);
         mv.add(key, value);
         return getBuf();
     }
 
+    /**
+     * Reserve the buffers for the fields that will be added.
+     * @param size The expected length in bytes of the document.
+     */
+    void reserve(size_t size)
+    {
+        mv.reserve(size);
+        owriter.reserve(buf[0], cap, size);
+    }
+
     /**
      * Set the document resource name.
      * @param name The resource name of the document.
@@ -159,6 +159,7 @@ protected:
 
         url(FPSTR("firestore.googleapis.com"));
 
+        request.opt.payload_size = request.options->payload.length();
         async_data_item_t *sData = request.aClient->createSlot(request.opt);
 
         if (!sData)
@@ -163,11 +163,17 @@ namespace Values
     public:
         /**
          * A integer value.
-         *  @param value The integer value
+         *  @param value The 64-bit integer value
          */
-        IntegerValue(int value)
+        IntegerValue(int64_t value)
         {
-            buf = StringValue(String(value)).c_str();
+            // The integer value is in JSON string.
+            char num[FIREBASE_NUMBER_BUF_SIZE + 2];
+            num[0] = '"';
+            size_t len = NumberFormat::format(num + 1, value);
+            num[len + 1] = '"';
+            num[len + 2] = 0;
+            buf = num;
             getVal();
         }
         const char *c_str() const { return buf.c_str(); }
@@ -195,7 +201,7 @@ namespace Values
          */
         DoubleValue(double value)
         {
-            buf = String(value);
+            NumberFormat::toString(buf, value);
             getVal();
         }
         const char *c_str() const { return buf.c_str(); }
@@ -299,7 +305,6 @@ namespace Values
     private:
         String buf, str;
         ObjectWriter owriter;
-        JSONUtil jut;
 
         const char *getVal() { return owriter.setPair(str, firestore_const_key[firestore_const_key_geoPointValue].text, buf); }
 
@@ -311,8 +316,14 @@ namespace Values
          */
         GeoPointValue(double lat, double lng)
         {
-            jut.addObject(buf, FPSTR("latitude"), String(lat), false);
-            jut.addObject(buf, FPSTR("longitude"), String(lng), false, true);
+            char num[FIREBASE_NUMBER_BUF_SIZE];
+            NumberFormat::format(num, lat);
+            buf = FPSTR("{\"latitude\":");
+            buf += num;
+            NumberFormat::format(num, lng);
+            buf += FPSTR(",\"longitude\":");
+            buf += num;
+            buf += '}';
             getVal();
         }
         const char *c_str() const { return buf.c_str(); }
@@ -330,16 +341,17 @@ namespace Values
 
     private:
         String buf, str;
+        size_t cap = 0;
         ObjectWriter owriter;
         bool flags[11];
 
         template <typename T>
         bool isExisted(T value)
         {
-            String tmp = value.val();
+            const char *v = value.val();
             for (size_t i = 0; i <= firestore_const_key_mapValue; i++)
             {
-                if (tmp.indexOf(firestore_const_key[i].text) > -1)
+                if (strstr(v, firestore_const_key[i].text))
                 {
                     if (flags[i])
                         return true;
@@ -370,7 +382,6 @@ namespace Values
         {
             memset(flags, 0, 11);
             set(value);
-            getVal();
         }
 
         /**
@@ -385,14 +396,19 @@ namespace Values
                 if (buf.length() == 0)
                     set(value);
                 else
-                    owriter.addMember(buf, value.val(), false, "]}");
-                getVal();
+                    owriter.appendValue(buf, cap, value.val(), FPSTR("]}"));
             }
             return *this;
         }
+
+        /**
+         * Reserve the buffer for the values that will be added.
+         * @param size The expected length in bytes of the array value.
+         */
+        void reserve(size_t size) { owriter.reserve(buf, cap, size); }
         const char *c_str() const { return buf.c_str(); }
         const char *val() { return getVal(); }
-        size_t printTo(Print &p) const { return p.print(str.c_str()); }
+        size_t printTo(Print &p) const { return owriter.printPair(p, firestore_const_key[firestore_const_key_arrayValue].text, buf); }
         void clear()
         {
             buf.remove(0, buf.length());
@@ -421,6 +437,7 @@ namespace Values
 
     private:
         String buf, str;
+        size_t cap = 0;
         ObjectWriter owriter;
         template <typename T>
         void set(const String &key, T value) { owriter.setPair(buf, FPSTR("fields"), MAP(key, value, true).c_str()); }
@@ -434,24 +451,25 @@ namespace Values
          * @param value The map value
          */
         template <typename T>
-        MapValue(const String &key, T value)
-        {
-            set(key, value);
-            getVal();
-        }
+        MapValue(const String &key, T value) { set(key, value); }
         template <typename T>
         MapValue &add(const String &key, T value)
         {
             if (buf.length() == 0)
                 set(key, value);
             else
-                owriter.addMember(buf, MAP(key, value, true).c_str(), false);
-            getVal();
+                owriter.appendPair(buf, cap, key, value.val(), FPSTR("}}"));
             return *this;
         }
+
+        /**
+         * Reserve the buffer for the fields that will be added.
+         * @param size The expected length in bytes of the map value.
+         */
+        void reserve(size_t size) { owriter.reserve(buf, cap, size); }
         const char *c_str() const { return buf.c_str(); }
         const char *val() { return getVal(); }
-        size_t printTo(Print &p) const { return p.print(str.c_str()); }
+        size_t printTo(Print &p) const { return owriter.printPair(p, firestore_const_key[firestore_const_key_mapValue].text, buf); }
         void clear()
         {
             buf.remove(0, buf.length());
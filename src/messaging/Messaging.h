@@ -200,6 +200,7 @@ private:
 
         url(FPSTR("fcm.googleapis.com"));
 
+        request.opt.payload_size = request.options->payload.length();
         async_data_item_t *sData = request.aClient->createSlot(request.opt);
 
         if (!sData)
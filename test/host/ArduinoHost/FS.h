@@ -0,0 +1,73 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef ARDUINO_HOST_FS_H
+#define ARDUINO_HOST_FS_H
+
+#include "Arduino.h"
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+enum SeekMode
+{
+    SeekSet = 0,
+    SeekCur = 1,
+    SeekEnd = 2
+};
+
+namespace fs
+{
+    // The file system is not available in the host test build, the file can't be opened.
+    class File : public Stream
+    {
+    public:
+        size_t write(uint8_t) override { return 0; }
+        size_t write(const uint8_t *buf, size_t size) override { return 0; }
+        int available() override { return 0; }
+        int read() override { return -1; }
+        int read(uint8_t *buf, size_t size) { return 0; }
+        int peek() override { return -1; }
+        bool seek(uint32_t pos, SeekMode mode = SeekSet) { return false; }
+        size_t position() const { return 0; }
+        size_t size() const { return 0; }
+        void close() {}
+        const char *name() const { return ""; }
+        explicit operator bool() const { return false; }
+    };
+
+    class FS
+    {
+    public:
+        File open(const char *path, const char *mode = FILE_READ) { return File(); }
+        bool exists(const char *path) { return false; }
+        bool remove(const char *path) { return false; }
+    };
+}
+
+using fs::File;
+using fs::FS;
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef ARDUINO_HOST_IP_ADDRESS_H
+#define ARDUINO_HOST_IP_ADDRESS_H
+
+#include <cstdint>
+#include <cstring>
+#include "WString.h"
+
+class IPAddress
+{
+public:
+    IPAddress() {}
+    IPAddress(uint8_t b1, uint8_t b2, uint8_t b3, uint8_t b4)
+    {
+        b[0] = b1;
+        b[1] = b2;
+        b[2] = b3;
+        b[3] = b4;
+    }
+    uint8_t operator[](int index) const { return b[index]; }
+    uint8_t &operator[](int index) { return b[index]; }
+    bool operator==(const IPAddress &ip) const { return memcmp(b, ip.b, 4) == 0; }
+    bool operator!=(const IPAddress &ip) const { return !(*this == ip); }
+    String toString() const
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", b[0], b[1], b[2], b[3]);
+        return buf;
+    }
+
+private:
+    uint8_t b[4] = {0};
+};
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef ARDUINO_HOST_WSTRING_H
+#define ARDUINO_HOST_WSTRING_H
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cstdint>
+#include <cctype>
+
+class __FlashStringHelper;
+
+// The Arduino String on std::string for the host (native) test build.
+class String
+{
+public:
+    String() {}
+    String(const char *c)
+    {
+        if (c)
+            s = c;
+    }
+    String(const std::string &c) : s(c) {}
+    String(const __FlashStringHelper *c)
+    {
+        if (c)
+            s = reinterpret_cast<const char *>(c);
+    }
+    explicit String(char c) : s(1, c) {}
+    explicit String(unsigned char v, unsigned char base = 10) { num(v, base); }
+    explicit String(int v, unsigned char base = 10)
+    {
+        if (base == 10)
+            s = std::to_string(v);
+        else
+            num((unsigned int)v, base);
+    }
+    explicit String(unsigned int v, unsigned char base = 10) { num(v, base); }
+    explicit String(long v, unsigned char base = 10)
+    {
+        if (base == 10)
+            s = std::to_string(v);
+        else
+            num((unsigned long)v, base);
+    }
+    explicit String(unsigned long v, unsigned char base = 10) { num(v, base); }
+    explicit String(long long v, unsigned char base = 10)
+    {
+        if (base == 10)
+            s = std::to_string(v);
+        else
+            num((unsigned long long)v, base);
+    }
+    explicit String(unsigned long long v, unsigned char base = 10) { num(v, base); }
+    explicit String(float v, unsigned int decimalPlaces = 2) { dec(v, decimalPlaces); }
+    explicit String(double v, unsigned int decimalPlaces = 2) { dec(v, decimalPlaces); }
+
+    const char *c_str() const { return s.c_str(); }
+    unsigned int length() const { return s.length(); }
+    bool reserve(unsigned int size)
+    {
+        s.reserve(size);
+        return true;
+    }
+    bool isEmpty() const { return s.empty(); }
+    void clear() { s.clear(); }
+
+    char operator[](unsigned int index) const { return index < s.size() ? s[index] : 0; }
+    char &operator[](unsigned int index)
+    {
+        static char dummy;
+        if (index >= s.size())
+        {
+            dummy = 0;
+            return dummy;
+        }
+        return s[index];
+    }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+    void setCharAt(unsigned int index, char c)
+    {
+        if (index < s.size())
+            s[index] = c;
+    }
+
+    String &operator+=(const String &v)
+    {
+        s += v.s;
+        return *this;
+    }
+    String &operator+=(const char *v)
+    {
+        if (v)
+            s += v;
+        return *this;
+    }
+    String &operator+=(char v)
+    {
+        s += v;
+        return *this;
+    }
+    template <typename T>
+    String &operator+=(T v) { return *this += String(v); }
+    template <typename T>
+    bool concat(T v)
+    {
+        *this += v;
+        return true;
+    }
+    bool concat(const char *v, unsigned int n)
+    {
+        if (!v)
+            return false;
+        s.append(v, n);
+        return true;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(s.find(c, from)); }
+    int indexOf(const String &v, unsigned int from = 0) const { return pos(s.find(v.s, from)); }
+    int lastIndexOf(char c) const { return pos(s.rfind(c)); }
+    int lastIndexOf(char c, unsigned int from) const { return pos(s.rfind(c, from)); }
+    int lastIndexOf(const String &v) const { return pos(s.rfind(v.s)); }
+    int lastIndexOf(const String &v, unsigned int from) const { return pos(s.rfind(v.s, from)); }
+
+    String substring(unsigned int begin) const { return begin > s.size() ? String() : String(s.substr(begin)); }
+    String substring(unsigned int begin, unsigned int end) const
+    {
+        if (begin > end)
+            std::swap(begin, end);
+        if (begin > s.size())
+            return String();
+        return String(s.substr(begin, end - begin));
+    }
+    void remove(unsigned int index)
+    {
+        if (index < s.size())
+            s.erase(index);
+    }
+    void remove(unsigned int index, unsigned int count)
+    {
+        if (index < s.size())
+            s.erase(index, count);
+    }
+    void replace(const String &find, const String &replace)
+    {
+        if (find.s.empty())
+            return;
+        size_t p = 0;
+        while ((p = s.find(find.s, p)) != std::string::npos)
+        {
+            s.replace(p, find.s.size(), replace.s);
+            p += replace.s.size();
+        }
+    }
+    void replace(char find, char replace)
+    {
+        for (auto &c : s)
+        {
+            if (c == find)
+                c = replace;
+        }
+    }
+    void trim()
+    {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos)
+        {
+            s.clear();
+            return;
+        }
+        s = s.substr(b, s.find_last_not_of(" \t\r\n") - b + 1);
+    }
+    void toLowerCase()
+    {
+        for (auto &c : s)
+            c = tolower(c);
+    }
+    void toUpperCase()
+    {
+        for (auto &c : s)
+            c = toupper(c);
+    }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+    double toDouble() const { return atof(s.c_str()); }
+
+    bool equals(const String &v) const { return s == v.s; }
+    bool startsWith(const String &v) const { return s.compare(0, v.s.size(), v.s) == 0; }
+    bool endsWith(const String &v) const { return s.size() >= v.s.size() && s.compare(s.size() - v.s.size(), v.s.size(), v.s) == 0; }
+    bool operator==(const String &v) const { return s == v.s; }
+    bool operator==(const char *v) const { return s == (v ? v : ""); }
+    bool operator!=(const String &v) const { return s != v.s; }
+    bool operator!=(const char *v) const { return s != (v ? v : ""); }
+    bool operator<(const String &v) const { return s < v.s; }
+    explicit operator bool() const { return true; }
+
+private:
+    std::string s;
+
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+
+    void num(unsigned long long v, unsigned char base)
+    {
+        char buf[70];
+        snprintf(buf, sizeof(buf), base == 16 ? "%llx" : (base == 8 ? "%llo" : "%llu"), v);
+        s = buf;
+    }
+
+    void dec(double v, unsigned int decimalPlaces)
+    {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, v);
+        s = buf;
+    }
+};
+
+inline String operator+(const String &a, const String &b)
+{
+    String r = a;
+    r += b;
+    return r;
+}
+inline String operator+(const String &a, const char *b)
+{
+    String r = a;
+    r += b;
+    return r;
+}
+inline String operator+(const char *a, const String &b)
+{
+    String r(a);
+    r += b;
+    return r;
+}
+inline String operator+(const String &a, char b)
+{
+    String r = a;
+    r += b;
+    return r;
+}
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * Created October 18, 2026
+ *
+ * The MIT License (MIT)
+ * Copyright (c) 2026 K. Suwatchai (Mobizt)
+ *
+ *
+ * Permission is hereby granted, free of charge, to any person returning a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+// The JSONTokenizer with the scalar scanning (FIREBASE_DISABLE_SIMD) to compare with the SIMD scanning in the same build.
+// The class is renamed so that it does not conflict with the JSONTokenizer of the other sources.
+#define FIREBASE_DISABLE_SIMD
+#define JSONTokenizer JSONTokenizerScalar
+#include <core/JSONTokenizer.h>
+
+// Get the number of tokens in the JSON content, or 0 on error.
+size_t scalarTokenCount(const char *data, size_t len)
+{
+    JSONTokenizerScalar tk(data, len);
+    json_token_t token;
+    size_t count = 0;
+    while ((token = tk.next()) != json_token_none)
+    {
+        if (token == json_token_error)
+            return 0;
+        count++;
+    }
+    return count;
+}
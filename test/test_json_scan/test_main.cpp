@@ -0,0 +1,289 @@
+/**
+ * The benchmark of JSON response scanning, the JSONTokenizer against the indexOf-based item parsing
+ * (StringUtil::parse) that was used before.
+ *
+ * The payloads are in the formats of the captured responses, OAuth2 token, Firestore runQuery (pretty-printed)
+ * and Realtime Database export (compact), the large payloads are built by repeating the captured items.
+ * Both methods should find the same values, the times are printed.
+ *
+ * The tokenizer with SIMD scanning (SSE2, AVX2 or NEON when the compiler targets them) is also compared with
+ * the scalar scanning (FIREBASE_DISABLE_SIMD, scalar_tokenizer.cpp) on the same payloads, both are scalar on MCU.
+ *
+ * Run with PlatformIO Test Runner, pio test -e native -f test_json_scan (host) or pio test -e esp32dev -f test_json_scan
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include <FirebaseClient.h>
+
+#define BENCH_ROUNDS 20
+
+#if defined(FIREBASE_JSON_SCAN_AVX2)
+#define JSON_SCAN_MODE "AVX2"
+#elif defined(FIREBASE_JSON_SCAN_SSE2)
+#define JSON_SCAN_MODE "SSE2"
+#elif defined(FIREBASE_JSON_SCAN_NEON)
+#define JSON_SCAN_MODE "NEON"
+#else
+#define JSON_SCAN_MODE "scalar"
+#endif
+
+#if defined(ESP32) || defined(ESP8266)
+#define RUN_QUERY_DOCS 100
+#define RTDB_NODES 400
+#else
+#define RUN_QUERY_DOCS 2000
+#define RTDB_NODES 20000
+#endif
+
+static const char token_response[] = "{\n  \"access_token\": \"ya29.c.c0ASRK0GZ8ye1pQyKX3bF9L1kGm2e7VzJYw2sTq6hHnPq3Jf0uXc8aDk4R9mLwQ1oNe7sYbT5vUiZr3Hh2GfCdEsAa\",\n  \"expires_in\": 3599,\n  \"token_type\": \"Bearer\"\n}";
+
+static const char run_query_item[] = "{\n  \"document\": {\n    \"name\": \"projects/test-project/databases/(default)/documents/sensors/s%d\",\n    \"fields\": {\n      \"temp\": {\n        \"doubleValue\": 25.5\n      },\n      \"hum\": {\n        \"integerValue\": \"%d\"\n      },\n      \"state\": {\n        \"stringValue\": \"running\"\n      }\n    },\n    \"createTime\": \"2024-05-01T08:15:30.123456Z\",\n    \"updateTime\": \"2024-05-01T08:15:30.123456Z\"\n  },\n  \"readTime\": \"2024-05-01T08:20:00.000000Z\"\n}";
+
+static const char rtdb_item[] = "\"s%d\":{\"t\":%d,\"h\":61,\"ts\":1714551330123,\"state\":\"running\"}";
+
+static String buildRunQuery(int n)
+{
+    String s;
+    char buf[sizeof(run_query_item) + 32];
+    s.reserve(n * sizeof(buf) + 8);
+    s += "[";
+    for (int i = 0; i < n; i++)
+    {
+        snprintf(buf, sizeof(buf), run_query_item, i, i % 100);
+        if (i > 0)
+            s += ",";
+        s += buf;
+    }
+    s += "]";
+    return s;
+}
+
+static String buildRTDB(int n)
+{
+    String s;
+    char buf[sizeof(rtdb_item) + 32];
+    s.reserve(n * sizeof(buf) + 16);
+    s += "{\"sensors\":{";
+    for (int i = 0; i < n; i++)
+    {
+        snprintf(buf, sizeof(buf), rtdb_item, i, i % 100);
+        if (i > 0)
+            s += ",";
+        s += buf;
+    }
+    s += "}}";
+    return s;
+}
+
+// The item parsing before the tokenizer, the value is taken from after the name to the delimiter.
+static bool parseItem(StringUtil &sut, const String &src, String &dest, const String &name, const String &delim, int &p1, int &p2)
+{
+    sut.parse(src, name, delim, p1, p2);
+    if (p1 > -1 && p2 > -1)
+    {
+        if (src[p1] == '"')
+            p1++;
+        if (src[p2 - 1] == '"')
+            p2--;
+        dest = src.substring(p1, p2);
+        p1 = p2;
+        return true;
+    }
+    return false;
+}
+
+// The token count of the JSONTokenizer that was built with FIREBASE_DISABLE_SIMD (scalar_tokenizer.cpp).
+size_t scalarTokenCount(const char *data, size_t len);
+
+static size_t tokenCount(const char *data, size_t len)
+{
+    JSONTokenizer tk(data, len);
+    json_token_t token;
+    size_t count = 0;
+    while ((token = tk.next()) != json_token_none)
+    {
+        if (token == json_token_error)
+            return 0;
+        count++;
+    }
+    return count;
+}
+
+static void report(const char *name, size_t len, unsigned long indexof_us, unsigned long tokenizer_us)
+{
+    char buf[160];
+    snprintf(buf, sizeof(buf), "%s (%u bytes): indexOf %lu us, tokenizer %lu us", name, (unsigned)len, indexof_us / BENCH_ROUNDS, tokenizer_us / BENCH_ROUNDS);
+    TEST_MESSAGE(buf);
+}
+
+void test_token_response()
+{
+    String payload = token_response;
+    StringUtil sut;
+    String token, expire, type, t2, e2, ty2;
+
+    unsigned long ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        int p1 = 0, p2 = 0;
+        parseItem(sut, payload, token, "\"access_token\"", ",", p1, p2);
+        parseItem(sut, payload, expire, "\"expires_in\"", ",", p1, p2);
+        parseItem(sut, payload, type, "\"token_type\"", "\n", p1, p2);
+    }
+    unsigned long indexof_us = micros() - ms;
+
+    ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        JSONTokenizer tk(payload.c_str(), payload.length());
+        json_token_t token_type;
+        while ((token_type = tk.next()) != json_token_none && token_type != json_token_error)
+        {
+            if (token_type != json_token_value || tk.depth() != 1)
+                continue;
+            if (tk.keyIs("access_token"))
+                tk.get(t2);
+            else if (tk.keyIs("expires_in"))
+                tk.get(e2);
+            else if (tk.keyIs("token_type"))
+                tk.get(ty2);
+        }
+    }
+    unsigned long tokenizer_us = micros() - ms;
+
+    report("OAuth2 token", payload.length(), indexof_us, tokenizer_us);
+    TEST_ASSERT_TRUE(token.length() > 0 && token == t2);
+    TEST_ASSERT_TRUE(expire == e2);
+    TEST_ASSERT_TRUE(type == ty2);
+}
+
+void test_run_query_response()
+{
+    String payload = buildRunQuery(RUN_QUERY_DOCS);
+    StringUtil sut;
+    String name;
+    size_t found = 0, found2 = 0, len = 0, len2 = 0;
+
+    unsigned long ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        int p1 = 0, p2 = 0;
+        found = 0;
+        len = 0;
+        while (parseItem(sut, payload, name, "\"name\"", ",", p1, p2))
+        {
+            found++;
+            len += name.length();
+        }
+    }
+    unsigned long indexof_us = micros() - ms;
+
+    ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        JSONTokenizer tk(payload.c_str(), payload.length());
+        json_token_t token;
+        found2 = 0;
+        len2 = 0;
+        while ((token = tk.next()) != json_token_none && token != json_token_error)
+        {
+            if (token == json_token_value && tk.depth() == 3 && tk.keyIs("name"))
+            {
+                tk.get(name);
+                found2++;
+                len2 += name.length();
+            }
+        }
+    }
+    unsigned long tokenizer_us = micros() - ms;
+
+    report("Firestore runQuery", payload.length(), indexof_us, tokenizer_us);
+    TEST_ASSERT_EQUAL_UINT32(RUN_QUERY_DOCS, found);
+    TEST_ASSERT_EQUAL_UINT32(found, found2);
+    TEST_ASSERT_EQUAL_UINT32(len, len2);
+}
+
+void test_rtdb_export()
+{
+    String payload = buildRTDB(RTDB_NODES);
+    StringUtil sut;
+    String value;
+    long sum = 0, sum2 = 0;
+
+    unsigned long ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        int p1 = 0, p2 = 0;
+        sum = 0;
+        while (parseItem(sut, payload, value, "\"t\"", ",", p1, p2))
+            sum += value.toInt();
+    }
+    unsigned long indexof_us = micros() - ms;
+
+    ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        JSONTokenizer tk(payload.c_str(), payload.length());
+        json_token_t token;
+        sum2 = 0;
+        while ((token = tk.next()) != json_token_none && token != json_token_error)
+        {
+            if (token == json_token_value && tk.depth() == 3 && tk.keyIs("t"))
+                sum2 += tk.toInt();
+        }
+    }
+    unsigned long tokenizer_us = micros() - ms;
+
+    report("RTDB export", payload.length(), indexof_us, tokenizer_us);
+    TEST_ASSERT_TRUE(sum > 0);
+    TEST_ASSERT_EQUAL_UINT32(sum, sum2);
+}
+
+static void compareScan(const char *name, const String &payload)
+{
+    size_t count = 0, count2 = 0;
+
+    unsigned long ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        count = tokenCount(payload.c_str(), payload.length());
+    unsigned long simd_us = micros() - ms;
+
+    ms = micros();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        count2 = scalarTokenCount(payload.c_str(), payload.length());
+    unsigned long scalar_us = micros() - ms;
+
+    char buf[160];
+    snprintf(buf, sizeof(buf), "%s (%u bytes, %u tokens): %s %lu us, scalar %lu us", name, (unsigned)payload.length(), (unsigned)count, JSON_SCAN_MODE, simd_us / BENCH_ROUNDS, scalar_us / BENCH_ROUNDS);
+    TEST_MESSAGE(buf);
+    TEST_ASSERT_TRUE(count > 0);
+    TEST_ASSERT_EQUAL_UINT32(count, count2);
+}
+
+void test_simd_scan()
+{
+    compareScan("Firestore runQuery", buildRunQuery(RUN_QUERY_DOCS));
+    compareScan("RTDB export", buildRTDB(RTDB_NODES));
+}
+
+int runUnityTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_token_response);
+    RUN_TEST(test_run_query_response);
+    RUN_TEST(test_rtdb_export);
+    RUN_TEST(test_simd_scan);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+void setup()
+{
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main() { return runUnityTests(); }
+#endif
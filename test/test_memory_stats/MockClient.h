@@ -0,0 +1,67 @@
+#ifndef TEST_MOCK_CLIENT_H
+#define TEST_MOCK_CLIENT_H
+
+#include <Arduino.h>
+#include <Client.h>
+
+// The network client that serves the preset server response without network.
+// The data is kept in the fixed buffer, it does not allocate the heap memory.
+class MockClient : public Client
+{
+public:
+    int connect(IPAddress ip, uint16_t port) override { return connect("", port); }
+    int connect(const char *host, uint16_t port) override
+    {
+        (void)host;
+        (void)port;
+        con = true;
+        return 1;
+    }
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t *buf, size_t size) override
+    {
+        (void)buf;
+        sent += size;
+        return size;
+    }
+    int available() override { return len - pos; }
+    int read() override { return pos < len ? buf[pos++] : -1; }
+    int read(uint8_t *dest, size_t size) override
+    {
+        size_t n = len - pos < size ? len - pos : size;
+        memcpy(dest, buf + pos, n);
+        pos += n;
+        return n;
+    }
+    int peek() override { return pos < len ? buf[pos] : -1; }
+    void flush() override {}
+    void stop() override { con = false; }
+    uint8_t connected() override { return con; }
+    operator bool() override { return con; }
+
+    // Append the data to be read.
+    bool serve(const char *data)
+    {
+        size_t n = strlen(data);
+        if (pos > 0)
+        {
+            memmove(buf, buf + pos, len - pos);
+            len -= pos;
+            pos = 0;
+        }
+        if (len + n > sizeof(buf))
+            return false;
+        memcpy(buf + len, data, n);
+        len += n;
+        return true;
+    }
+
+    size_t sentBytes() const { return sent; }
+
+private:
+    uint8_t buf[4096];
+    size_t len = 0, pos = 0, sent = 0;
+    bool con = false;
+};
+
+#endif
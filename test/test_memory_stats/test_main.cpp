@@ -0,0 +1,161 @@
+/**
+ * The heap allocation bounds of the library operations in steady state.
+ *
+ * All heap allocations (including String) are counted per operation type by MemoryStats with the malloc interposer,
+ * the server responses are served by MockClient without network.
+ *
+ * Run with PlatformIO Test Runner, pio test -e native_memory_stats (host) or pio test -e esp32dev_memory_stats
+ * The env (platformio.ini) defines FIREBASE_MEMORY_STATS and FIREBASE_MEMORY_STATS_INTERPOSE (and wraps the malloc functions on ESP32).
+ *
+ * The objects are static as the library keeps the object addresses in 32-bit integers,
+ * the native env links the position dependent executable to keep the addresses of static and heap objects below 4 GB.
+ */
+#include <Arduino.h>
+#include <unity.h>
+#include <FirebaseClient.h>
+#include <core/MemoryInterpose.h>
+#include "MockClient.h"
+
+// The heap allocations per SSE event.
+#define SSE_EVENT_ALLOC_MAX 0
+
+// The heap allocations per set and get request while the request is processed.
+#define SET_ALLOC_MAX 16
+#define GET_ALLOC_MAX 16
+
+// The number of events or requests to be done before and while counting.
+#define WARMUP_COUNT 5
+#define TEST_COUNT 50
+
+static const char sse_header[] = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n\r\n";
+static const char sse_event[] = "event: put\ndata: {\"path\":\"/\",\"data\":{\"temp\":25.5,\"hum\":61,\"state\":\"running\"}}\n\n";
+static const char json_response[] = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 2\r\n\r\n25";
+
+static void netConnect() {}
+static void netStatus(bool &status) { status = true; }
+
+static size_t event_count = 0, result_count = 0;
+
+static void onEvent(AsyncResult &aResult)
+{
+    if (!aResult.available())
+        return;
+    RealtimeDatabaseResult &stream = aResult.to<RealtimeDatabaseResult>();
+    if (stream.isStream() && stream.data().length())
+        event_count++;
+}
+
+static void onResult(AsyncResult &aResult)
+{
+    if (aResult.available())
+        result_count++;
+}
+
+static void run(FirebaseApp &app, RealtimeDatabase &db, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        app.loop();
+        db.loop();
+    }
+}
+
+void test_interposer_counts_string()
+{
+    MemoryStats::reset();
+    String s;
+    s.reserve(256);
+    TEST_ASSERT_TRUE_MESSAGE(MemoryStats::get(mem_op_other).count > 0, "The malloc interposer is not linked, check the build flags.");
+}
+
+void test_sse_event_steady_state()
+{
+    static MockClient client;
+    static GenericNetwork network(netConnect, netStatus);
+    static AsyncClientClass aClient(client, getNetwork(network));
+    static FirebaseApp app;
+    static LegacyToken legacy_token("test-token");
+    static RealtimeDatabase db;
+
+    initializeApp(aClient, app, getAuth(legacy_token));
+    app.getApp<RealtimeDatabase>(db);
+    db.url("test-default-rtdb.firebaseio.com");
+    db.get(aClient, "/stream", onEvent, true /* SSE */, "stream");
+
+    client.serve(sse_header);
+    for (int i = 0; i < WARMUP_COUNT; i++)
+    {
+        client.serve(sse_event);
+        run(app, db, 5);
+    }
+    TEST_ASSERT_EQUAL_UINT32(WARMUP_COUNT, event_count);
+
+    MemoryStats::reset();
+    for (int i = 0; i < TEST_COUNT; i++)
+    {
+        client.serve(sse_event);
+        run(app, db, 5);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(WARMUP_COUNT + TEST_COUNT, event_count);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SSE_EVENT_ALLOC_MAX * TEST_COUNT, MemoryStats::get(mem_op_sse_event).count);
+}
+
+void test_set_get_steady_state()
+{
+    static MockClient client;
+    static GenericNetwork network(netConnect, netStatus);
+    static AsyncClientClass aClient(client, getNetwork(network));
+    static FirebaseApp app;
+    static LegacyToken legacy_token("test-token");
+    static RealtimeDatabase db;
+
+    initializeApp(aClient, app, getAuth(legacy_token));
+    app.getApp<RealtimeDatabase>(db);
+    db.url("test-default-rtdb.firebaseio.com");
+
+    size_t in_use = 0;
+    for (int i = 0; i < WARMUP_COUNT + TEST_COUNT; i++)
+    {
+        if (i == WARMUP_COUNT)
+        {
+            MemoryStats::reset();
+            in_use = MemoryStats::inUse();
+        }
+
+        client.serve(json_response);
+        db.set<int>(aClient, "/test/int", 25, onResult, "set");
+        run(app, db, 10);
+
+        client.serve(json_response);
+        db.get(aClient, "/test/int", onResult, false, "get");
+        run(app, db, 10);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32((WARMUP_COUNT + TEST_COUNT) * 2, result_count);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SET_ALLOC_MAX * TEST_COUNT, MemoryStats::get(mem_op_set).count);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(GET_ALLOC_MAX * TEST_COUNT, MemoryStats::get(mem_op_get).count);
+    // The memory that is kept by the client and the app should not grow.
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(in_use, MemoryStats::inUse());
+}
+
+int runUnityTests()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_interposer_counts_string);
+    RUN_TEST(test_sse_event_steady_state);
+    RUN_TEST(test_set_get_steady_state);
+    return UNITY_END();
+}
+
+#if defined(ARDUINO)
+void setup()
+{
+    delay(2000);
+    runUnityTests();
+}
+
+void loop() {}
+#else
+int main() { return runUnityTests(); }
+#endif